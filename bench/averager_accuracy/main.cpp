@@ -0,0 +1,217 @@
+// Compares the float and Q16.16 averaging pipelines, and a filter_pipeline
+// of the same stage kinds and lengths, against the double reference
+// (batch_averager) on recorded or synthetic distance data, then
+// each horizon of a multi_horizon_averager against a reference of the same
+// length, with the cost of one multi-horizon averager next to the separate
+// averagers it replaces.
+//
+//   averager_accuracy [recording.csv]
+//
+// The recording holds one PDAT sample per line; the first column is the
+// distance in meters, further columns are ignored. Without a file a
+// synthetic trace (noise, outliers, slow drift, step changes) is used.
+#include "averager.hpp"
+#include "fixed_batch_averager.hpp"
+#include "multi_horizon_averager.hpp"
+#include "filter_pipeline.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+static constexpr size_t window = 20;
+
+static std::vector<float> load_recording(const char *path)
+{
+    std::vector<float> samples;
+    FILE *f = std::fopen(path, "r");
+    if (!f)
+    {
+        std::perror(path);
+        return samples;
+    }
+    char line[256];
+    while (std::fgets(line, sizeof(line), f))
+    {
+        char *end = nullptr;
+        float value = std::strtof(line, &end);
+        if (end != line)
+            samples.push_back(value);
+    }
+    std::fclose(f);
+    return samples;
+}
+
+static std::vector<float> synthetic_trace(size_t count)
+{
+    std::mt19937 rng(42);
+    std::normal_distribution<float> noise(0.0f, 0.004f);
+    std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+
+    std::vector<float> samples;
+    samples.reserve(count);
+    float target = 3.2f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        target += 0.00002f;
+        if (i % 5000 == 4999)
+            target += 0.03f;
+        float x = target + noise(rng);
+        if (uni(rng) < 0.03f)
+            x += (uni(rng) - 0.5f) * 0.6f;
+        samples.push_back(x);
+    }
+    return samples;
+}
+
+struct error_stats
+{
+    double max_mm = 0.0;
+    double sum_sq_mm = 0.0;
+    size_t n = 0;
+    size_t mm_mismatch = 0;
+    double ns_per_sample = 0.0;
+};
+
+template <typename Averager>
+static error_stats compare(const std::vector<float> &samples)
+{
+    batch_averager reference(window);
+    Averager candidate;
+    error_stats st;
+    double ns = 0.0;
+
+    for (float x : samples)
+    {
+        reference.add_sample(x);
+
+        auto t0 = std::chrono::steady_clock::now();
+        candidate.add_sample(x);
+        auto t1 = std::chrono::steady_clock::now();
+        ns += std::chrono::duration<double, std::nano>(t1 - t0).count();
+
+        if (!reference.is_complete())
+            continue;
+
+        double err_mm = std::fabs(candidate.average_meters() - reference.average_meters()) * 1000.0;
+        st.max_mm = std::fmax(st.max_mm, err_mm);
+        st.sum_sq_mm += err_mm * err_mm;
+        ++st.n;
+        if (candidate.average_millimeters() != reference.average_millimeters())
+            ++st.mm_mismatch;
+    }
+    st.ns_per_sample = samples.empty() ? 0.0 : ns / static_cast<double>(samples.size());
+    return st;
+}
+
+// Step limiter, Hampel and trimmed mean as per-sample stages. They do not
+// re-filter the window as batch_averager does, so this row shows how far the
+// composed pipeline departs from it, not a rounding error.
+using robust_pipeline = filter_pipeline<float, step_limiter<float>, hampel<float, window>, trimmed_mean<float, window>>;
+
+// Horizon lengths of the multi-horizon comparison
+static constexpr size_t short_horizon = 5;
+static constexpr size_t long_horizon = 80;
+using horizons_averager = multi_horizon_averager<float, short_horizon, window, long_horizon>;
+
+struct horizon_stats
+{
+    error_stats err[horizons_averager::horizon_count];
+    double multi_ns_per_sample = 0.0;
+    double separate_ns_per_sample = 0.0;
+    uint32_t outliers = 0;
+};
+
+static double elapsed_ns(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static horizon_stats compare_horizons(const std::vector<float> &samples)
+{
+    batch_averager references[] = {batch_averager(short_horizon), batch_averager(window), batch_averager(long_horizon)};
+    horizons_averager multi;
+    fixed_batch_averager<short_horizon, float> separate_short;
+    fixed_batch_averager<window, float> separate_mid;
+    fixed_batch_averager<long_horizon, float> separate_long;
+    horizon_stats st;
+    double multi_ns = 0.0;
+    double separate_ns = 0.0;
+
+    for (float x : samples)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        multi.add_sample(x);
+        multi_ns += elapsed_ns(t0);
+
+        t0 = std::chrono::steady_clock::now();
+        separate_short.add_sample(x);
+        separate_mid.add_sample(x);
+        separate_long.add_sample(x);
+        separate_ns += elapsed_ns(t0);
+
+        for (size_t i = 0; i < horizons_averager::horizon_count; ++i)
+        {
+            references[i].add_sample(x);
+            if (!references[i].is_complete() || !multi.is_complete(i))
+                continue;
+
+            error_stats &e = st.err[i];
+            const double err_mm = std::fabs(multi.average_meters(i) - references[i].average_meters()) * 1000.0;
+            e.max_mm = std::fmax(e.max_mm, err_mm);
+            e.sum_sq_mm += err_mm * err_mm;
+            ++e.n;
+            if (multi.average_millimeters(i) != references[i].average_millimeters())
+                ++e.mm_mismatch;
+        }
+    }
+
+    const double n = samples.empty() ? 1.0 : static_cast<double>(samples.size());
+    st.multi_ns_per_sample = multi_ns / n;
+    st.separate_ns_per_sample = separate_ns / n;
+    st.outliers = multi.outliers();
+    return st;
+}
+
+static void print_row(const char *name, const error_stats &st)
+{
+    std::printf("%-8s %12.5f %12.5f %14zu %10.1f\n", name, st.max_mm,
+                st.n ? std::sqrt(st.sum_sq_mm / static_cast<double>(st.n)) : 0.0,
+                st.mm_mismatch, st.ns_per_sample);
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<float> samples = argc > 1 ? load_recording(argv[1]) : synthetic_trace(200000);
+    if (samples.empty())
+        return 1;
+
+    std::printf("%zu samples (%s), window %zu, errors vs. double batch_averager\n",
+                samples.size(), argc > 1 ? argv[1] : "synthetic", window);
+    std::printf("%-8s %12s %12s %14s %10s\n", "type", "max err mm", "rms err mm", "mm reg differs", "ns/sample");
+    print_row("double", compare<fixed_batch_averager<window, double>>(samples));
+    print_row("float", compare<fixed_batch_averager<window, float>>(samples));
+    print_row("q16_16", compare<fixed_batch_averager<window, q16_16>>(samples));
+    print_row("pipeline", compare<robust_pipeline>(samples));
+
+    // Plain means behind a shared outlier gate, against robust references
+    const horizon_stats hz = compare_horizons(samples);
+    std::printf("\nmulti_horizon_averager<float, %zu, %zu, %zu> vs. double batch_averager of each length\n",
+                short_horizon, window, long_horizon);
+    std::printf("%-8s %12s %12s %14s\n", "horizon", "max err mm", "rms err mm", "mm reg differs");
+    for (size_t i = 0; i < horizons_averager::horizon_count; ++i)
+    {
+        const error_stats &e = hz.err[i];
+        std::printf("%-8zu %12.5f %12.5f %14zu\n", horizons_averager::length(i), e.max_mm,
+                    e.n ? std::sqrt(e.sum_sq_mm / static_cast<double>(e.n)) : 0.0, e.mm_mismatch);
+    }
+    std::printf("%u samples dropped by the Hampel gate\n", hz.outliers);
+    std::printf("one multi-horizon averager: %6.1f ns/sample, %5zu bytes\n",
+                hz.multi_ns_per_sample, sizeof(horizons_averager));
+    std::printf("three fixed_batch_averagers: %5.1f ns/sample, %5zu bytes\n", hz.separate_ns_per_sample,
+                sizeof(fixed_batch_averager<short_horizon, float>) + sizeof(fixed_batch_averager<window, float>) +
+                    sizeof(fixed_batch_averager<long_horizon, float>));
+    return 0;
+}
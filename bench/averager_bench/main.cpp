@@ -0,0 +1,405 @@
+// Times add_sample() of the averaging pipelines across window sizes, outlier
+// rates and noise distributions, and counts the heap traffic it causes.
+//
+//   averager_bench [--quick] [--baseline FILE] [--write-baseline FILE] [--tolerance F]
+//
+// --baseline compares every row against a stored run and exits non-zero if a
+// case got slower by more than the tolerance (default 0.5 = 50 %) or
+// allocates more per sample than before. Timings are machine dependent, so
+// refresh the stored baseline with --write-baseline when changing hosts.
+// --quick runs shorter traces, which time differently (more of each run is
+// cache warm-up), so a baseline only compares against runs of its own mode.
+#include "averager.hpp"
+#include "fixed_batch_averager.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------
+// Heap accounting: every allocation in the process goes through these.
+//----------------------------------------------
+namespace heap
+{
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> current{0};
+    std::atomic<size_t> peak{0};
+
+    // Size header kept in front of each block so delete can account for it
+    constexpr size_t header = alignof(std::max_align_t);
+
+    void *allocate(size_t size)
+    {
+        auto *block = static_cast<unsigned char *>(std::malloc(size + header));
+        if (!block)
+            throw std::bad_alloc();
+        std::memcpy(block, &size, sizeof(size));
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        size_t now = current.fetch_add(size, std::memory_order_relaxed) + size;
+        size_t prev = peak.load(std::memory_order_relaxed);
+        while (now > prev && !peak.compare_exchange_weak(prev, now, std::memory_order_relaxed))
+        {
+        }
+        return block + header;
+    }
+
+    void release(void *ptr) noexcept
+    {
+        if (!ptr)
+            return;
+        auto *block = static_cast<unsigned char *>(ptr) - header;
+        size_t size;
+        std::memcpy(&size, block, sizeof(size));
+        current.fetch_sub(size, std::memory_order_relaxed);
+        std::free(block);
+    }
+}
+
+void *operator new(size_t size) { return heap::allocate(size); }
+void *operator new[](size_t size) { return heap::allocate(size); }
+void operator delete(void *ptr) noexcept { heap::release(ptr); }
+void operator delete[](void *ptr) noexcept { heap::release(ptr); }
+void operator delete(void *ptr, size_t) noexcept { heap::release(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { heap::release(ptr); }
+
+//----------------------------------------------
+// Workloads
+//----------------------------------------------
+enum class distribution_t
+{
+    gaussian,
+    uniform,
+    laplace,
+};
+
+static const char *to_string(distribution_t d)
+{
+    switch (d)
+    {
+    case distribution_t::gaussian:
+        return "gaussian";
+    case distribution_t::uniform:
+        return "uniform";
+    case distribution_t::laplace:
+        return "laplace";
+    }
+    return "?";
+}
+
+// Distance trace around 3 m with 4 mm noise of the given shape; a fraction
+// outlier_rate of the samples is replaced by a spurious return up to ±0.3 m.
+static std::vector<float> make_trace(size_t count, distribution_t dist, double outlier_rate)
+{
+    std::mt19937 rng(1234);
+    std::normal_distribution<float> gauss(0.0f, 0.004f);
+    std::uniform_real_distribution<float> uni(-0.0069f, 0.0069f); // same sigma as gauss
+    std::exponential_distribution<float> expo(1.0f / 0.0028f);    // laplace scale, sigma 4 mm
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<float> samples;
+    samples.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        float noise = 0.0f;
+        switch (dist)
+        {
+        case distribution_t::gaussian:
+            noise = gauss(rng);
+            break;
+        case distribution_t::uniform:
+            noise = uni(rng);
+            break;
+        case distribution_t::laplace:
+            noise = unit(rng) < 0.5f ? expo(rng) : -expo(rng);
+            break;
+        }
+        float x = 3.0f + noise;
+        if (unit(rng) < outlier_rate)
+            x += (unit(rng) - 0.5f) * 0.6f;
+        samples.push_back(x);
+    }
+    return samples;
+}
+
+//----------------------------------------------
+// Measurement
+//----------------------------------------------
+struct result_t
+{
+    std::string impl;
+    size_t window;
+    distribution_t dist;
+    double outlier_rate;
+    double ns_per_sample;
+    double allocs_per_sample;
+    size_t object_bytes; // sizeof the averager itself
+    size_t heap_peak;    // peak heap bytes owned by it (construction + run)
+};
+
+static std::string key_of(const std::string &impl, size_t window, const char *dist, double rate)
+{
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), "%s,%zu,%s,%.3f", impl.c_str(), window, dist, rate);
+    return buf;
+}
+
+static volatile uint32_t g_sink; // keeps the results observable
+
+static constexpr int timing_passes = 3;
+
+template <typename Make>
+static result_t run_case(const char *impl, size_t window, distribution_t dist, double rate,
+                         const std::vector<float> &trace, Make make)
+{
+    const size_t heap_before = heap::current.load();
+    heap::peak.store(heap_before);
+
+    auto avg = make();
+
+    // Fill the window untimed so the timed part is steady state
+    const size_t warmup = window;
+    for (size_t i = 0; i < warmup; ++i)
+        avg->add_sample(trace[i]);
+
+    // Best of a few passes over the trace filters scheduler noise
+    const size_t allocs_before = heap::allocations.load();
+    double best_ns = 0.0;
+    uint32_t sink = 0;
+    for (int pass = 0; pass < timing_passes; ++pass)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = warmup; i < trace.size(); ++i)
+        {
+            avg->add_sample(trace[i]);
+            sink += avg->average_millimeters();
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        if (pass == 0 || ns < best_ns)
+            best_ns = ns;
+    }
+    g_sink = sink;
+
+    const size_t timed = trace.size() - warmup;
+    result_t r;
+    r.impl = impl;
+    r.window = window;
+    r.dist = dist;
+    r.outlier_rate = rate;
+    r.ns_per_sample = best_ns / static_cast<double>(timed);
+    r.allocs_per_sample = static_cast<double>(heap::allocations.load() - allocs_before) /
+                          static_cast<double>(timed * timing_passes);
+    r.object_bytes = sizeof(*avg);
+    r.heap_peak = heap::peak.load() - heap_before - sizeof(*avg); // the holder below is bench overhead
+    return r;
+}
+
+// The averagers live on the heap so large fixed windows do not blow the
+// stack; the holder allocation is subtracted from heap_peak again.
+template <size_t N, typename T>
+static auto make_fixed()
+{
+    return std::make_unique<fixed_batch_averager<N, T>>();
+}
+
+// Weighted averager fed a magnitude with every sample, spread like the
+// sensor's 0.01 dB readings, so the weighted trimmed mean does real work
+template <size_t N>
+struct weighted_fixed
+{
+    fixed_batch_averager<N, float, true> avg;
+    uint32_t state = 1;
+
+    void add_sample(float meters) noexcept
+    {
+        state = state * 1664525u + 1013904223u;
+        avg.add_sample(meters, static_cast<uint16_t>(3000 + (state >> 22)));
+    }
+
+    uint16_t average_millimeters() const noexcept { return avg.average_millimeters(); }
+};
+
+template <size_t N>
+static auto make_weighted()
+{
+    return std::make_unique<weighted_fixed<N>>();
+}
+
+static constexpr std::array<size_t, 8> window_sizes{8, 16, 32, 64, 128, 256, 512, 1024};
+
+template <size_t... I>
+static void run_windows(std::index_sequence<I...>, distribution_t dist, double rate, bool quick,
+                        std::vector<result_t> &out)
+{
+    auto run_one = [&](auto n_constant)
+    {
+        constexpr size_t n = decltype(n_constant)::value;
+        // The legacy averager sorts the window twice per sample, so scale the
+        // trace length down with the window to keep the run time bounded.
+        const size_t count = n + std::max<size_t>(quick ? 1000 : 2000, (quick ? 100000 : 1000000) / n);
+        const std::vector<float> trace = make_trace(count, dist, rate);
+
+        out.push_back(run_case("batch_averager", n, dist, rate, trace,
+                               [n] { return std::make_unique<batch_averager>(n); }));
+        out.push_back(run_case("fixed<double>", n, dist, rate, trace, make_fixed<n, double>));
+        out.push_back(run_case("fixed<float>", n, dist, rate, trace, make_fixed<n, float>));
+        out.push_back(run_case("fixed<q16_16>", n, dist, rate, trace, make_fixed<n, q16_16>));
+        out.push_back(run_case("weighted<float>", n, dist, rate, trace, make_weighted<n>));
+    };
+    (run_one(std::integral_constant<size_t, window_sizes[I]>{}), ...);
+}
+
+//----------------------------------------------
+// Baseline file: one CSV row per case
+//----------------------------------------------
+struct baseline_row
+{
+    double ns_per_sample;
+    double allocs_per_sample;
+};
+
+static const char *mode_name(bool quick) { return quick ? "quick" : "full"; }
+
+// Baselines written before the mode line was added are full runs
+static std::map<std::string, baseline_row> load_baseline(const char *path, std::string &mode)
+{
+    std::map<std::string, baseline_row> rows;
+    mode = mode_name(false);
+    FILE *f = std::fopen(path, "r");
+    if (!f)
+    {
+        std::perror(path);
+        return rows;
+    }
+    char line[256];
+    while (std::fgets(line, sizeof(line), f))
+    {
+        char mode_buf[16];
+        if (std::sscanf(line, "# mode: %15s", mode_buf) == 1)
+        {
+            mode = mode_buf;
+            continue;
+        }
+
+        char impl[48];
+        char dist[16];
+        size_t window;
+        double rate;
+        baseline_row row;
+        if (std::sscanf(line, "%47[^,],%zu,%15[^,],%lf,%lf,%lf", impl, &window, dist, &rate,
+                        &row.ns_per_sample, &row.allocs_per_sample) == 6)
+            rows[key_of(impl, window, dist, rate)] = row;
+    }
+    std::fclose(f);
+    return rows;
+}
+
+static bool write_baseline(const char *path, const std::vector<result_t> &results, bool quick)
+{
+    FILE *f = std::fopen(path, "w");
+    if (!f)
+    {
+        std::perror(path);
+        return false;
+    }
+    std::fprintf(f, "# mode: %s\n", mode_name(quick));
+    std::fprintf(f, "# impl,window,distribution,outlier_rate,ns_per_sample,allocs_per_sample\n");
+    for (const auto &r : results)
+        std::fprintf(f, "%s,%.2f,%.4f\n", key_of(r.impl, r.window, to_string(r.dist), r.outlier_rate).c_str(),
+                     r.ns_per_sample, r.allocs_per_sample);
+    std::fclose(f);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *baseline_path = nullptr;
+    const char *write_path = nullptr;
+    double tolerance = 0.5;
+    bool quick = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--quick"))
+            quick = true;
+        else if (!std::strcmp(argv[i], "--baseline") && i + 1 < argc)
+            baseline_path = argv[++i];
+        else if (!std::strcmp(argv[i], "--write-baseline") && i + 1 < argc)
+            write_path = argv[++i];
+        else if (!std::strcmp(argv[i], "--tolerance") && i + 1 < argc)
+            tolerance = std::atof(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--quick] [--baseline FILE] [--write-baseline FILE] [--tolerance F]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::map<std::string, baseline_row> baseline;
+    if (baseline_path)
+    {
+        std::string baseline_mode;
+        baseline = load_baseline(baseline_path, baseline_mode);
+        if (baseline.empty())
+            return 2;
+        if (baseline_mode != mode_name(quick))
+        {
+            std::fprintf(stderr, "%s holds a %s run; compare it with a %s run or write a %s baseline\n",
+                         baseline_path, baseline_mode.c_str(), baseline_mode.c_str(), mode_name(quick));
+            return 2;
+        }
+    }
+
+    std::vector<result_t> results;
+    for (distribution_t dist : {distribution_t::gaussian, distribution_t::uniform, distribution_t::laplace})
+        for (double rate : {0.0, 0.05, 0.20})
+            run_windows(std::make_index_sequence<window_sizes.size()>{}, dist, rate, quick, results);
+
+    std::printf("%-16s %6s %-9s %8s %12s %12s %10s %10s  %s\n", "impl", "window", "noise", "outliers",
+                "ns/sample", "allocs/smp", "object B", "heap pk B", baseline_path ? "vs baseline" : "");
+
+    size_t regressions = 0;
+    for (const auto &r : results)
+    {
+        char verdict[48] = "";
+        auto it = baseline.find(key_of(r.impl, r.window, to_string(r.dist), r.outlier_rate));
+        if (baseline_path && it == baseline.end())
+        {
+            std::snprintf(verdict, sizeof(verdict), "new");
+        }
+        else if (baseline_path)
+        {
+            const double change = r.ns_per_sample / it->second.ns_per_sample - 1.0;
+            const bool slower = change > tolerance;
+            const bool allocs = r.allocs_per_sample > it->second.allocs_per_sample + 1e-3;
+            std::snprintf(verdict, sizeof(verdict), "%+6.1f%%%s%s", change * 100.0,
+                          slower ? " SLOWER" : "", allocs ? " MORE-ALLOCS" : "");
+            if (slower || allocs)
+                ++regressions;
+        }
+
+        std::printf("%-16s %6zu %-9s %7.0f%% %12.1f %12.3f %10zu %10zu  %s\n", r.impl.c_str(), r.window,
+                    to_string(r.dist), r.outlier_rate * 100.0, r.ns_per_sample, r.allocs_per_sample,
+                    r.object_bytes, r.heap_peak, verdict);
+    }
+
+    if (write_path && !write_baseline(write_path, results, quick))
+        return 2;
+
+    if (regressions > 0)
+    {
+        std::printf("%zu regression(s) against %s\n", regressions, baseline_path);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,289 @@
+// Checks the averaging building blocks on short scripted inputs:
+// the filter_pipeline stages, the alpha-beta tracker, the
+// multi-horizon averager and the age limit of fixed_batch_averager.
+//
+//   averager_checks
+//
+// Exits non-zero if any check fails.
+#include "filter_pipeline.hpp"
+#include "alpha_beta_tracker.hpp"
+#include "multi_horizon_averager.hpp"
+#include "fixed_batch_averager.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <deque>
+#include <numeric>
+
+static constexpr size_t window = 20;
+
+using robust_pipeline = filter_pipeline<float, step_limiter<float>, hampel<float, window>, trimmed_mean<float, window>>;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    std::printf("%-52s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok)
+        ++failures;
+}
+
+static void check_pipeline()
+{
+    std::printf("filter_pipeline<float, step_limiter, hampel<%zu>, trimmed_mean<%zu>>\n", window, window);
+
+    robust_pipeline p;
+    for (int i = 0; i < 40; ++i)
+        p.add_sample(3.2 + ((i % 2) ? 0.002 : -0.002));
+    check(p.is_complete() && std::fabs(p.average_meters() - 3.2) < 0.001, "steady target averages to itself");
+
+    const double before = p.average_meters();
+    check(!p.add_sample(3.5) && p.average_meters() == before, "single jump over max_step is dropped");
+    check(!p.add_sample(3.23) && p.average_meters() == before, "in-step Hampel outlier is dropped");
+
+    for (int i = 0; i < 5; ++i)
+        p.add_sample(4.0);
+    check(p.stage<0>().reacquisitions() == 1, "consistent step re-acquires the target");
+
+    check(!p.add_sample(std::nan("")), "non-finite sample is dropped");
+
+    filter_pipeline<float, ema<float>> smooth(ema<float>(0.5));
+    smooth.add_sample(1.0);
+    smooth.add_sample(2.0);
+    check(std::fabs(smooth.average_meters() - 1.5) < 1e-6, "ema blends with alpha");
+
+    filter_pipeline<float, time_ema<float>> timed(time_ema<float>(100.0));
+    timed.add_sample(1.0, 0);
+    timed.add_sample(2.0, 100000);
+    const double after_tau = timed.average_meters();
+    timed.add_sample(9.0, 100000);
+    check(std::fabs(after_tau - (2.0 - std::exp(-1.0))) < 1e-4, "time_ema reaches 63 % after tau");
+    check(timed.average_meters() == after_tau, "time_ema holds on a repeated timestamp");
+
+    p.reset();
+    check(!p.is_complete(), "reset clears the output");
+}
+
+// Feed a target at x0 + v * t, one frame every period_us, from t0_us
+static void feed_track(alpha_beta_tracker<float> &t, float x0, float v, int64_t t0_us, int64_t period_us, int frames)
+{
+    for (int i = 0; i < frames; ++i)
+    {
+        const int64_t ts = t0_us + i * period_us;
+        t.update(x0 + v * static_cast<float>(ts) * 1e-6f, ts);
+    }
+}
+
+static void check_tracker()
+{
+    std::printf("\nalpha_beta_tracker<float>\n");
+    constexpr int64_t period_us = 20000;
+
+    alpha_beta_tracker<float> t;
+    check(t.update(3.0f, 0) && !t.is_tracking(), "first sample is only a seed candidate");
+    feed_track(t, 3.0f, -0.5f, period_us, period_us, 100);
+    check(t.is_tracking() && std::fabs(t.velocity() + 0.5f) < 1e-3f, "constant velocity is estimated");
+    const int64_t last_us = 100 * period_us;
+    check(std::fabs(t.distance() - (3.0f - 0.5f * 2.0f)) < 1e-3f, "constant velocity has no lag");
+    check(std::fabs(t.predict(last_us + period_us) - (3.0f - 0.5f * 2.02f)) < 1e-3f, "prediction extrapolates");
+
+    const float before = t.distance();
+    check(!t.update(2.0f, last_us) && t.distance() == before, "repeated timestamp is rejected");
+    check(!t.update(2.0f, last_us - period_us) && t.distance() == before, "older timestamp is rejected");
+
+    check(!t.update(5.0f, last_us + period_us) && t.is_tracking(), "outlier beyond the gate is rejected");
+    check(t.update(3.0f - 0.5f * 2.04f, last_us + 2 * period_us) && std::fabs(t.velocity() + 0.5f) < 0.01f,
+          "track continues after a gated outlier");
+
+    // The target jumps 1 m and stays: max_misses misses, then a new track
+    alpha_beta_tracker<float> jump;
+    feed_track(jump, 2.0f, 0.0f, 0, period_us, 50);
+    int frames_to_lock = 0;
+    for (int i = 0; i < 20 && frames_to_lock == 0; ++i)
+    {
+        jump.update(3.0f, (50 + i) * period_us);
+        if (jump.is_tracking() && std::fabs(jump.distance() - 3.0f) < 1e-3f)
+            frames_to_lock = i + 1;
+    }
+    check(frames_to_lock == 6, "jump is followed after max_misses + 1 frames");
+    check(std::fabs(jump.velocity()) < 1e-3f, "re-seeded track starts at rest");
+
+    // An outlier right after a reset must not become the track
+    alpha_beta_tracker<float> seed;
+    seed.update(9.0f, 0);
+    seed.update(2.0f, period_us);
+    check(!seed.is_tracking(), "inconsistent seed pair does not lock");
+    check(seed.update(2.01f, 2 * period_us) && seed.is_tracking() && std::fabs(seed.distance() - 2.01f) < 1e-6f,
+          "next consistent pair seeds the track");
+
+    check(!seed.update(std::nanf(""), 3 * period_us), "non-finite sample is rejected");
+}
+
+using horizons = multi_horizon_averager<float, 5, 20, 80>;
+
+// Largest difference, over all horizons, between the averager and the exact
+// mean of the newest samples in `kept` (meters)
+static double horizon_error(const horizons &avg, const std::deque<double> &kept)
+{
+    double worst = 0.0;
+    for (size_t i = 0; i < horizons::horizon_count; ++i)
+    {
+        const size_t n = std::min(kept.size(), horizons::length(i));
+        const double exact = std::accumulate(kept.end() - static_cast<std::ptrdiff_t>(n), kept.end(), 0.0) / double(n);
+        worst = std::fmax(worst, std::fabs(avg.average_meters(i) - exact));
+    }
+    return worst;
+}
+
+static void remember(std::deque<double> &kept, double x)
+{
+    kept.push_back(static_cast<float>(x));
+    if (kept.size() > horizons::capacity)
+        kept.pop_front();
+}
+
+static void check_multi_horizon()
+{
+    std::printf("\nmulti_horizon_averager<float, 5, 20, 80>\n");
+
+    // Gate off, no steps: every horizon is the plain mean of its samples.
+    // A million samples span ~4000 re-summations, so drift would show.
+    horizons plain(0.05, 0.0);
+    std::deque<double> kept;
+    double worst = 0.0;
+    for (int i = 0; i < 1000000; ++i)
+    {
+        const double x = 3.2 + 0.001 * ((i * 7) % 13 - 6) + 1e-7 * (i % 100000);
+        plain.add_sample(x);
+        remember(kept, x);
+        worst = std::fmax(worst, horizon_error(plain, kept));
+    }
+    check(worst < 1e-5, "horizons stay within 0.01 mm of exact over 1M");
+    check(plain.outliers() == 0 && plain.is_complete(2), "disabled gate passes everything");
+
+    // Gate on: a -1/0/+1 mm pattern passes, in-step spikes of 30 mm do not,
+    // and the horizons are exact means of what passed
+    horizons gated;
+    kept.clear();
+    worst = 0.0;
+    uint32_t spikes = 0;
+    for (int i = 0; i < 10000; ++i)
+    {
+        static constexpr int pattern[] = {-1, 0, 1, 0};
+        const double base = 2.5 + 1e-6 * i + 0.001 * pattern[i % 4];
+        if (i >= 20 && i % 10 == 7)
+        {
+            gated.add_sample(base + 0.03);
+            ++spikes;
+        }
+        else
+        {
+            gated.add_sample(base);
+            remember(kept, base);
+        }
+        worst = std::fmax(worst, horizon_error(gated, kept));
+    }
+    check(gated.outliers() == spikes, "Hampel gate drops exactly the spikes");
+    check(worst < 1e-5, "gated horizons are exact means of the rest");
+
+    // A sustained 0.2 m step re-seeds every horizon from the run alone
+    for (int i = 0; i < 4; ++i)
+        gated.add_sample(3.0);
+    check(gated.reacquisitions() == 0 && std::fabs(gated.average_meters(2) - 2.51) < 0.01,
+          "step shorter than the run is ignored");
+    gated.add_sample(3.0);
+    bool reseeded = gated.reacquisitions() == 1 && gated.last_settling_samples() == 5;
+    for (size_t i = 0; i < horizons::horizon_count; ++i)
+        reseeded = reseeded && std::fabs(gated.average_meters(i) - 3.0) < 1e-6 &&
+                   gated.is_complete(i) == (horizons::length(i) <= 5);
+    check(reseeded, "consistent step re-seeds all horizons");
+
+    gated.reset();
+    check(gated.outliers() == 0 && !gated.is_complete(0) && gated.average_meters(0) == 0.0, "reset clears everything");
+}
+
+// Window shape of the firmware: 64 frames of room, 20 at 50 Hz, 400 ms
+using timed_averager = fixed_batch_averager<64, float, false, true>;
+static constexpr uint32_t span_ms = 400;
+
+// Time from a 30 mm step until the output is within 1 mm of the new position.
+// Frames come every period_us, or with random_spacing anywhere from half to
+// one and a half periods apart; every drop_every-th is lost (0 keeps all).
+// With age_limit false the window is bounded by 20 frames only.
+static int64_t step_response_ms(int64_t period_us, int drop_every, bool random_spacing, bool age_limit)
+{
+    timed_averager avg;
+    avg.set_window(20);
+    if (age_limit)
+        avg.set_max_age_ms(span_ms);
+
+    static constexpr int pattern[] = {-1, 0, 1, 0};
+    const int64_t step_us = 3000000;
+    uint32_t lcg = 1;
+    int64_t ts = 0;
+    for (int i = 0; ts < step_us + 2000000; ++i)
+    {
+        lcg = lcg * 1664525u + 1013904223u;
+        ts += random_spacing ? period_us / 2 + static_cast<int64_t>(lcg >> 8) % period_us : period_us;
+        if (drop_every > 0 && i % drop_every == drop_every - 1)
+            continue;
+
+        const double x = (ts < step_us ? 1.0 : 1.03) + 0.001 * pattern[i % 4];
+        avg.add_sample(x, 0, ts);
+        if (ts >= step_us && std::fabs(avg.average_meters() - 1.03) < 0.001)
+            return (ts - step_us) / 1000;
+    }
+    return -1;
+}
+
+static void check_time_window()
+{
+    std::printf("\nfixed_batch_averager<64, float> with a %u ms age limit\n", span_ms);
+
+    const int64_t nominal = step_response_ms(20000, 0, false, true);
+    const int64_t halved = step_response_ms(40000, 0, false, true);
+    const int64_t dropped = step_response_ms(20000, 3, false, true);
+    const int64_t irregular = step_response_ms(20000, 0, true, true);
+    const int64_t frames_only = step_response_ms(40000, 0, false, false);
+    std::printf("step response: 50 Hz %lld ms, 25 Hz %lld ms, 50 Hz 1/3 dropped %lld ms, "
+                "10-30 ms spacing %lld ms, 25 Hz frames only %lld ms\n",
+                static_cast<long long>(nominal), static_cast<long long>(halved), static_cast<long long>(dropped),
+                static_cast<long long>(irregular), static_cast<long long>(frames_only));
+
+    // Within two of the slowest frame periods of the nominal response
+    check(nominal > 0 && nominal <= span_ms, "step settles within the span at 50 Hz");
+    check(halved > 0 && std::llabs(halved - nominal) <= 80, "halved rate settles in the same time");
+    check(dropped > 0 && std::llabs(dropped - nominal) <= 80, "dropped frames settle in the same time");
+    check(irregular > 0 && std::llabs(irregular - nominal) <= 80, "irregular spacing settles in the same time");
+    check(frames_only > halved + 100, "frame-count window alone stretches at half rate");
+
+    // Samples older than the limit leave even when the window is not full
+    timed_averager avg;
+    avg.set_window(20);
+    avg.set_max_age_ms(span_ms);
+    for (int i = 0; i < 5; ++i)
+        avg.add_sample(2.0, 0, i * 100000);
+    check(!avg.is_complete(), "window below the span is not complete");
+    avg.add_sample(2.0, 0, 500000);
+    check(avg.is_complete() && std::fabs(avg.average_meters() - 2.0) < 1e-6, "aged-out window publishes");
+
+    // After a gap longer than the span the newest sample still anchors the
+    // step limiter, so one far-off sample is not taken as the new position
+    avg.add_sample(2.5, 0, 5000000);
+    check(std::fabs(avg.average_meters() - 2.0) < 1e-6, "limiter keeps its reference across a gap");
+    for (int i = 1; i < 5; ++i)
+        avg.add_sample(2.5, 0, 5000000 + i * 20000);
+    check(avg.reacquisitions() == 1 && std::fabs(avg.average_meters() - 2.5) < 1e-6, "gap followed by a move re-seeds");
+}
+
+int main()
+{
+    check_pipeline();
+    check_tracker();
+    check_multi_horizon();
+    check_time_window();
+
+    if (failures)
+        std::printf("%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
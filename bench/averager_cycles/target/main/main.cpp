@@ -0,0 +1,95 @@
+#include "fixed_batch_averager.hpp"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cinttypes>
+#include <cstdio>
+
+static constexpr char TAG[] = "AveragerCycles";
+
+// Same shape as the firmware averager: capacity 64, active window 20
+static constexpr size_t bench_capacity = 64;
+static constexpr size_t bench_window = 20;
+static constexpr uint32_t bench_samples = 20000;
+
+// Synthetic trace in the style of bench/averager_accuracy: a drifting target
+// with noise, a 3 % rate of outliers and a step every 5000 samples. A fixed
+// LCG keeps every type on the same input.
+class trace_source
+{
+public:
+    float next() noexcept
+    {
+        target_ += 0.00002f;
+        if (++i_ % 5000 == 0)
+            target_ += 0.03f;
+        float x = target_ + (uniform() + uniform() + uniform() - 1.5f) * 0.008f;
+        if (uniform() < 0.03f)
+            x += (uniform() - 0.5f) * 0.6f;
+        return x;
+    }
+
+private:
+    float uniform() noexcept
+    {
+        state_ = state_ * 1664525u + 1013904223u;
+        return static_cast<float>(state_ >> 8) * (1.0f / 16777216.0f);
+    }
+
+    uint32_t state_ = 42;
+    uint32_t i_ = 0;
+    float target_ = 3.2f;
+};
+
+struct cycle_stats
+{
+    uint32_t mean = 0;
+    uint32_t max = 0;
+};
+
+template <typename T>
+static cycle_stats measure()
+{
+    static fixed_batch_averager<bench_capacity, T> averager;
+    averager.reset();
+    averager.set_window(bench_window);
+
+    trace_source trace;
+    uint64_t total = 0;
+    cycle_stats st;
+    for (uint32_t i = 0; i < bench_samples; ++i)
+    {
+        const float x = trace.next();
+        const uint32_t c0 = esp_cpu_get_cycle_count();
+        averager.add_sample(x);
+        const uint32_t cycles = esp_cpu_get_cycle_count() - c0;
+
+        total += cycles;
+        if (cycles > st.max)
+            st.max = cycles;
+        if (i % 1000 == 999)
+            vTaskDelay(1); // let the idle task feed the watchdog
+    }
+    st.mean = static_cast<uint32_t>(total / bench_samples);
+    return st;
+}
+
+static void print_row(const char *name, const cycle_stats &st)
+{
+    printf("%-8s %12" PRIu32 " %12" PRIu32 "\n", name, st.mean, st.max);
+}
+
+extern "C" void app_main()
+{
+    ESP_LOGI(TAG, "fixed_batch_averager<%u>, window %u, %" PRIu32 " samples per type",
+             static_cast<unsigned>(bench_capacity), static_cast<unsigned>(bench_window), bench_samples);
+    printf("%-8s %12s %12s\n", "type", "cycles/smpl", "max cycles");
+
+    // Max includes any interrupt taken during the call; the mean is the figure
+    print_row("double", measure<double>());
+    print_row("float", measure<float>());
+    print_row("q16_16", measure<q16_16>());
+
+    ESP_LOGI(TAG, "Done");
+}
@@ -0,0 +1,53 @@
+#include "pty_transport.hpp"
+#include "uart_bench.hpp"
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+
+static int64_t now_us()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t frames = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 2000;
+
+    int master_fd = -1;
+    int slave_fd = -1;
+    if (!pty_transport::open_pair(master_fd, slave_fd))
+    {
+        std::perror("pty");
+        return 1;
+    }
+    pty_transport tx(master_fd);
+    pty_transport rx(slave_fd);
+
+    static constexpr int baud_rates[] = {115200, 460800, 921600, 2000000};
+    static constexpr size_t frame_sizes[] = {9, 14, 64, 256};
+    static constexpr uart_bench::read_strategy_t strategies[] = {
+        uart_bench::read_strategy_t::read_exact,
+        uart_bench::read_strategy_t::chunked,
+    };
+    static constexpr uint32_t bursts[] = {1, 8};
+
+    std::printf("pty loopback, %" PRIu32 " frames per row (baud rate is nominal on a pty)\n", frames);
+    uart_bench::print_header();
+
+    for (int baud : baud_rates)
+    {
+        tx.set_baud_rate(baud);
+        rx.set_baud_rate(baud);
+        for (size_t frame_size : frame_sizes)
+            for (auto strategy : strategies)
+                for (uint32_t burst : bursts)
+                {
+                    uart_bench::config_t cfg{baud, frame_size, strategy, frames, 10, burst};
+                    auto res = uart_bench::run(tx, rx, cfg, now_us);
+                    uart_bench::print_row("pty", cfg, res);
+                }
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include "transport.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <chrono>
+
+// One end of a host pseudo-terminal pair, modelling byte_transport. Ticks are
+// 10 ms to match the target's CONFIG_FREERTOS_HZ=100. A pty moves bytes at
+// memory speed, so the baud rate is recorded but does not pace the link.
+class pty_transport
+{
+public:
+    static constexpr int tick_ms = 10;
+    static constexpr int err_ok = 0;
+    static constexpr int err_fail = -1;
+    static constexpr int err_timeout = 0x107;
+
+    explicit pty_transport(int fd) noexcept : fd_(fd) {}
+
+    pty_transport(const pty_transport &) = delete;
+    pty_transport &operator=(const pty_transport &) = delete;
+
+    ~pty_transport() noexcept
+    {
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    // Opens a master/slave pair in raw mode. Returns false on failure.
+    static bool open_pair(int &master_fd, int &slave_fd) noexcept
+    {
+        master_fd = ::posix_openpt(O_RDWR | O_NOCTTY);
+        if (master_fd < 0 || ::grantpt(master_fd) != 0 || ::unlockpt(master_fd) != 0)
+            return false;
+
+        const char *name = ::ptsname(master_fd);
+        slave_fd = name ? ::open(name, O_RDWR | O_NOCTTY) : -1;
+        if (slave_fd < 0)
+            return false;
+
+        return make_raw(master_fd) && make_raw(slave_fd);
+    }
+
+    int read(uint8_t *dst, size_t max_len, uint32_t ticks_to_wait) noexcept
+    {
+        pollfd pfd{fd_, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, static_cast<int>(ticks_to_wait) * tick_ms);
+        if (ready < 0)
+            return errno == EINTR ? 0 : -1;
+        if (ready == 0)
+            return 0;
+
+        ssize_t n = ::read(fd_, dst, max_len);
+        if (n < 0)
+            return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+        return static_cast<int>(n);
+    }
+
+    int read_exact(uint8_t *dst, size_t max_len, uint32_t ticks_to_wait = 10) noexcept
+    {
+        if (!dst || max_len == 0)
+            return err_fail;
+
+        using clock = std::chrono::steady_clock;
+        const auto deadline = clock::now() + std::chrono::milliseconds(ticks_to_wait * tick_ms);
+        size_t total_read = 0;
+
+        while (total_read < max_len)
+        {
+            const auto now = clock::now();
+            if (now >= deadline)
+                return err_timeout;
+
+            auto remaining_ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+            uint32_t remaining_ticks = static_cast<uint32_t>((remaining_ms + tick_ms - 1) / tick_ms);
+
+            int n = read(dst + total_read, max_len - total_read, remaining_ticks);
+            if (n < 0)
+                return err_fail;
+            total_read += static_cast<size_t>(n);
+        }
+        return err_ok;
+    }
+
+    int write(const uint8_t *data, size_t len) noexcept
+    {
+        size_t written = 0;
+        while (written < len)
+        {
+            ssize_t n = ::write(fd_, data + written, len - written);
+            if (n < 0)
+            {
+                if (errno == EINTR || errno == EAGAIN)
+                    continue;
+                return -1;
+            }
+            written += static_cast<size_t>(n);
+        }
+        return static_cast<int>(written);
+    }
+
+    void flush_buffer() noexcept { ::tcflush(fd_, TCIFLUSH); }
+
+    int baud_rate() const noexcept { return baud_rate_; }
+
+    int set_baud_rate(int baud_rate) noexcept
+    {
+        baud_rate_ = baud_rate;
+        return err_ok;
+    }
+
+private:
+    static bool make_raw(int fd) noexcept
+    {
+        termios tio{};
+        if (::tcgetattr(fd, &tio) != 0)
+            return false;
+        ::cfmakeraw(&tio);
+        return ::tcsetattr(fd, TCSANOW, &tio) == 0;
+    }
+
+    int fd_;
+    int baud_rate_ = 115200;
+};
+
+static_assert(byte_transport<pty_transport>, "pty_transport must model byte_transport");
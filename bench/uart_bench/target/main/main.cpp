@@ -0,0 +1,77 @@
+#include "uart.hpp"
+#include "uart_bench.hpp"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cinttypes>
+#include <cstdio>
+
+static constexpr char TAG[] = "UartBench";
+
+// TX and RX of this port must be jumpered together.
+static constexpr uart_port_t bench_port = UART_NUM_1;
+static constexpr int bench_tx_pin = 12;
+static constexpr int bench_rx_pin = 13;
+static constexpr uint32_t bench_frames = 500;
+
+static int64_t now_us()
+{
+    return esp_timer_get_time();
+}
+
+extern "C" void app_main()
+{
+    // rx_buf_size as passed to uart; the driver ring is twice this
+    static constexpr size_t rx_buf_sizes[] = {128, 512, 2048};
+    static constexpr int baud_rates[] = {115200, 460800, 921600, 2000000};
+    static constexpr size_t frame_sizes[] = {9, 14, 64, 256};
+    static constexpr uart_bench::read_strategy_t strategies[] = {
+        uart_bench::read_strategy_t::read_exact,
+        uart_bench::read_strategy_t::chunked,
+    };
+    static constexpr uint32_t bursts[] = {1, 4};
+
+    ESP_LOGI(TAG, "UART%d loopback, %" PRIu32 " frames per row", bench_port, bench_frames);
+    uart_bench::print_header();
+
+    for (size_t rx_buf_size : rx_buf_sizes)
+    {
+        // The driver is installed per buffer size and deleted when port leaves scope
+        uart port(bench_port, bench_tx_pin, bench_rx_pin, 115200, rx_buf_size);
+        if (port.init(UART_DATA_8_BITS, UART_PARITY_EVEN, UART_STOP_BITS_1) != ESP_OK)
+        {
+            ESP_LOGE(TAG, "UART init failed with a %u byte RX buffer", static_cast<unsigned>(rx_buf_size));
+            continue;
+        }
+
+        for (int baud : baud_rates)
+        {
+            if (port.set_baud_rate(baud) != ESP_OK)
+                continue;
+
+            for (size_t frame_size : frame_sizes)
+            {
+                const uart::rx_tuning_t tunings[] = {uart::rx_tuning_default, uart::rx_tuning_low_latency(frame_size)};
+                const char *tuning_names[] = {"default", "lowlat"};
+
+                for (size_t t = 0; t < 2; ++t)
+                {
+                    char label[16];
+                    snprintf(label, sizeof(label), "%s/%u", tuning_names[t], static_cast<unsigned>(rx_buf_size));
+
+                    port.set_rx_tuning(tunings[t]);
+                    for (auto strategy : strategies)
+                        for (uint32_t burst : bursts)
+                        {
+                            uart_bench::config_t cfg{baud, frame_size, strategy, bench_frames, 10, burst};
+                            auto res = uart_bench::run(port, port, cfg, now_us);
+                            uart_bench::print_row(label, cfg, res);
+                        }
+                    vTaskDelay(1);
+                }
+            }
+        }
+    }
+
+    ESP_LOGI(TAG, "Done");
+}
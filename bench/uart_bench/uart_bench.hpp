@@ -0,0 +1,151 @@
+#pragma once
+#include "transport.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Loopback benchmark for byte transports. Every frame written on tx must come
+// back unchanged on rx (TX jumpered to RX on the target, a pty pair on the host).
+namespace uart_bench
+{
+    enum class read_strategy_t : uint8_t
+    {
+        read_exact = 0, // one read_exact() call with a deadline, as vld1 does
+        chunked = 1,    // repeated read() of whatever is buffered, 1-tick waits
+    };
+
+    struct config_t
+    {
+        int baud_rate;
+        size_t frame_size;
+        read_strategy_t strategy;
+        uint32_t frames;
+        uint32_t timeout_ticks;
+        uint32_t burst; // frames written back-to-back before reading them back
+    };
+
+    struct result_t
+    {
+        uint32_t frames;
+        uint32_t timeouts;
+        uint32_t corrupt;
+        double throughput_bps; // payload bits per second delivered intact
+        int64_t p50_us;
+        int64_t p90_us;
+        int64_t p99_us;
+        int64_t max_us;
+    };
+
+    inline const char *strategy_name(read_strategy_t strategy) noexcept
+    {
+        return strategy == read_strategy_t::read_exact ? "read_exact" : "chunked";
+    }
+
+    template <byte_transport Transport>
+    bool read_frame(Transport &rx, uint8_t *dst, size_t len, const config_t &cfg)
+    {
+        if (cfg.strategy == read_strategy_t::read_exact)
+            return rx.read_exact(dst, len, cfg.timeout_ticks) == 0;
+
+        size_t total = 0;
+        for (uint32_t waited = 0; total < len && waited < cfg.timeout_ticks; ++waited)
+        {
+            int n = rx.read(dst + total, len - total, 1);
+            if (n < 0)
+                return false;
+            total += static_cast<size_t>(n);
+        }
+        return total == len;
+    }
+
+    inline int64_t percentile(const std::vector<int64_t> &sorted, double p) noexcept
+    {
+        if (sorted.empty())
+            return 0;
+        size_t idx = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(idx, sorted.size() - 1)];
+    }
+
+    // Clock returns a monotonic time in microseconds.
+    template <byte_transport Tx, byte_transport Rx, typename Clock>
+    result_t run(Tx &tx, Rx &rx, const config_t &cfg, Clock now_us)
+    {
+        result_t res{};
+        const uint32_t burst = cfg.burst ? cfg.burst : 1;
+        std::vector<uint8_t> out(cfg.frame_size * burst);
+        std::vector<uint8_t> in(cfg.frame_size);
+        std::vector<int64_t> latencies;
+        latencies.reserve(cfg.frames / burst + 1);
+
+        rx.flush_buffer();
+
+        uint64_t good_bytes = 0;
+        uint32_t seq = 0;
+        const int64_t run_start = now_us();
+
+        while (res.frames < cfg.frames)
+        {
+            const uint32_t count = std::min(burst, cfg.frames - res.frames);
+            for (size_t i = 0; i < count * cfg.frame_size; ++i)
+                out[i] = static_cast<uint8_t>((seq + i * 7u) & 0xFF);
+
+            const int64_t t0 = now_us();
+            tx.write(out.data(), count * cfg.frame_size);
+
+            bool lost_sync = false;
+            for (uint32_t f = 0; f < count; ++f)
+            {
+                if (!read_frame(rx, in.data(), cfg.frame_size, cfg))
+                {
+                    res.timeouts += count - f;
+                    lost_sync = true;
+                    break;
+                }
+                if (!std::equal(in.begin(), in.end(), out.begin() + f * cfg.frame_size))
+                {
+                    ++res.corrupt;
+                    continue;
+                }
+                good_bytes += cfg.frame_size;
+            }
+            res.frames += count;
+
+            if (lost_sync)
+                rx.flush_buffer();
+            else
+                latencies.push_back(now_us() - t0);
+
+            seq += count;
+        }
+
+        const int64_t elapsed = now_us() - run_start;
+        res.throughput_bps = elapsed > 0 ? static_cast<double>(good_bytes) * 8.0 * 1e6 / static_cast<double>(elapsed) : 0.0;
+
+        std::sort(latencies.begin(), latencies.end());
+        res.p50_us = percentile(latencies, 0.50);
+        res.p90_us = percentile(latencies, 0.90);
+        res.p99_us = percentile(latencies, 0.99);
+        res.max_us = latencies.empty() ? 0 : latencies.back();
+        return res;
+    }
+
+    inline void print_header() noexcept
+    {
+        std::printf("%-12s %-7s %-6s %-10s %-7s %10s %9s %9s %9s %9s %8s %8s\n",
+                    "label", "baud", "frame", "strategy", "burst", "kbit/s",
+                    "p50 us", "p90 us", "p99 us", "max us", "timeout", "corrupt");
+    }
+
+    inline void print_row(const char *label, const config_t &cfg, const result_t &res) noexcept
+    {
+        std::printf("%-12s %-7d %-6zu %-10s %-7" PRIu32 " %10.1f %9lld %9lld %9lld %9lld %8" PRIu32 " %8" PRIu32 "\n",
+                    label, cfg.baud_rate, cfg.frame_size, strategy_name(cfg.strategy), cfg.burst,
+                    res.throughput_bps / 1000.0,
+                    static_cast<long long>(res.p50_us), static_cast<long long>(res.p90_us),
+                    static_cast<long long>(res.p99_us), static_cast<long long>(res.max_us),
+                    res.timeouts, res.corrupt);
+    }
+}
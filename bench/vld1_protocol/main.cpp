@@ -0,0 +1,211 @@
+// Drives the VLD1 PDAT exchange (vld1_protocol::request_pdat, the code behind
+// vld1::get_pdat) over a scripted in-memory transport and checks the request
+// bytes, the decoded payload and every error path, then times the exchange.
+//
+//   vld1_protocol [frames]
+//
+// Exits non-zero if any check fails.
+#include "vld1_frame.hpp"
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// byte_transport whose receive side replays scripted bytes and whose send
+// side records what was written. Reads past the script time out.
+class fake_transport
+{
+public:
+    static constexpr int err_ok = 0;
+    static constexpr int err_timeout = 0x107;
+
+    void script(const void *data, size_t len)
+    {
+        const auto *bytes = static_cast<const uint8_t *>(data);
+        rx_.insert(rx_.end(), bytes, bytes + len);
+    }
+
+    void rewind() noexcept
+    {
+        rx_pos_ = 0;
+        tx_.clear();
+    }
+
+    void clear() noexcept
+    {
+        rx_.clear();
+        rewind();
+    }
+
+    const std::vector<uint8_t> &sent() const noexcept { return tx_; }
+
+    int read(uint8_t *dst, size_t max_len, uint32_t) noexcept
+    {
+        const size_t n = std::min(max_len, rx_.size() - rx_pos_);
+        std::memcpy(dst, rx_.data() + rx_pos_, n);
+        rx_pos_ += n;
+        return static_cast<int>(n);
+    }
+
+    int read_exact(uint8_t *dst, size_t len, uint32_t ticks = 10) noexcept
+    {
+        return read(dst, len, ticks) == static_cast<int>(len) ? err_ok : err_timeout;
+    }
+
+    int write(const uint8_t *src, size_t len) noexcept
+    {
+        tx_.insert(tx_.end(), src, src + len);
+        return static_cast<int>(len);
+    }
+
+    void flush_buffer() noexcept { rx_pos_ = rx_.size(); }
+    int baud_rate() const noexcept { return baud_; }
+    int set_baud_rate(int baud) noexcept
+    {
+        baud_ = baud;
+        return err_ok;
+    }
+
+private:
+    std::vector<uint8_t> rx_;
+    std::vector<uint8_t> tx_;
+    size_t rx_pos_ = 0;
+    int baud_ = 115200;
+};
+
+static_assert(byte_transport<fake_transport>, "fake_transport must model byte_transport");
+
+using proto = vld1_protocol;
+using status_t = proto::vld1_error_code_t;
+
+static int64_t fake_clock_us = 0;
+static int64_t tick_clock() noexcept { return fake_clock_us += 100; }
+
+static int64_t now_us()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static proto::resp_t make_resp(status_t status)
+{
+    proto::resp_t resp{};
+    std::memcpy(resp.header.header, "RESP", 4);
+    resp.header.payload_len = sizeof(status_t);
+    resp.err_code = status;
+    return resp;
+}
+
+static proto::pdat_resp_t make_pdat(float distance, uint16_t magnitude)
+{
+    proto::pdat_resp_t pdat{};
+    std::memcpy(pdat.header.header, "PDAT", 4);
+    pdat.header.payload_len = sizeof(proto::pdat_payload_t);
+    pdat.payload.distance = distance;
+    pdat.payload.magnitude = magnitude;
+    return pdat;
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    std::printf("%-52s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok)
+        ++failures;
+}
+
+static status_t exchange(fake_transport &link, proto::pdat_payload_t &out, proto::pdat_timing_t *timing = nullptr)
+{
+    return proto::request_pdat(link, out, timing, tick_clock);
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t frames = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 200000;
+
+    fake_transport link;
+    proto::pdat_payload_t out{};
+    proto::pdat_timing_t timing{};
+
+    // Valid exchange
+    const proto::resp_t ok_resp = make_resp(status_t::OK);
+    const proto::pdat_resp_t pdat = make_pdat(3.217f, 4210);
+    link.script(&ok_resp, sizeof(ok_resp));
+    link.script(&pdat, sizeof(pdat));
+    check(exchange(link, out, &timing) == status_t::OK, "valid frame decodes");
+    check(out.distance == 3.217f && out.magnitude == 4210, "payload matches");
+
+    const uint8_t gnfd[] = {'G', 'N', 'F', 'D', 1, 0, 0, 0, static_cast<uint8_t>(proto::gnfd_payload_t::PDAT)};
+    check(link.sent().size() == sizeof(gnfd) && std::memcmp(link.sent().data(), gnfd, sizeof(gnfd)) == 0,
+          "GNFD request bytes");
+    check(timing.gnfd_sent_us > 0 && timing.resp_received_us > timing.gnfd_sent_us &&
+              timing.pdat_decoded_us > timing.resp_received_us,
+          "stage timestamps ordered");
+
+    // Sensor rejects the request: status is passed through, no PDAT is read
+    link.clear();
+    const proto::resp_t busy = make_resp(status_t::TIMEOUT);
+    link.script(&busy, sizeof(busy));
+    check(exchange(link, out, &timing) == status_t::TIMEOUT, "RESP error status passed through");
+    check(timing.resp_received_us == 0 && timing.pdat_decoded_us == 0, "timing stops at failed stage");
+
+    // Nothing answers
+    link.clear();
+    check(exchange(link, out) == status_t::RESP_FRAME_ERR, "silent sensor -> RESP_FRAME_ERR");
+
+    // Garbage instead of RESP
+    link.clear();
+    proto::resp_t bad_resp = ok_resp;
+    std::memcpy(bad_resp.header.header, "RESX", 4);
+    link.script(&bad_resp, sizeof(bad_resp));
+    check(exchange(link, out) == status_t::RESP_FRAME_ERR, "bad RESP header -> RESP_FRAME_ERR");
+
+    // RESP without the PDAT frame that should follow
+    link.clear();
+    link.script(&ok_resp, sizeof(ok_resp));
+    check(exchange(link, out) == status_t::RESP_FRAME_ERR, "missing PDAT -> RESP_FRAME_ERR");
+
+    // Wrong frame type or length after RESP
+    link.clear();
+    proto::pdat_resp_t wrong = pdat;
+    std::memcpy(wrong.header.header, "RFFT", 4);
+    link.script(&ok_resp, sizeof(ok_resp));
+    link.script(&wrong, sizeof(wrong));
+    check(exchange(link, out) == status_t::INVALID_DATA_RECEIVED, "wrong frame type -> INVALID_DATA_RECEIVED");
+
+    link.clear();
+    wrong = pdat;
+    wrong.header.payload_len = 4;
+    link.script(&ok_resp, sizeof(ok_resp));
+    link.script(&wrong, sizeof(wrong));
+    check(exchange(link, out) == status_t::INVALID_DATA_RECEIVED, "bad PDAT length -> INVALID_DATA_RECEIVED");
+
+    // Oversized frame is refused by the encoder
+    uint8_t buf[proto::max_frame_len];
+    proto::vld1_header_t big{};
+    big.payload_len = proto::max_frame_len;
+    check(proto::encode_frame(big, buf, buf, sizeof(buf)) == 0, "oversized frame not encoded");
+
+    // Cost of one exchange on this host, transport overhead included
+    link.clear();
+    link.script(&ok_resp, sizeof(ok_resp));
+    link.script(&pdat, sizeof(pdat));
+    double checksum = 0.0;
+    const int64_t start = now_us();
+    for (uint32_t i = 0; i < frames; ++i)
+    {
+        link.rewind();
+        exchange(link, out, &timing);
+        checksum += out.distance;
+    }
+    const int64_t elapsed = now_us() - start;
+    std::printf("\n%u exchanges in %lld us (%.1f ns each, checksum %.0f)\n", frames,
+                static_cast<long long>(elapsed), frames ? 1000.0 * elapsed / frames : 0.0, checksum);
+
+    if (failures)
+        std::printf("%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+
+// Alpha-beta tracker for timestamped distance samples. Estimates distance and
+// radial velocity with O(1) time and memory per sample and, unlike a window
+// average, does not lag a moving target by half a window.
+//
+// Residuals larger than gate are treated as outliers: the state coasts on its
+// prediction. After max_misses consecutive outliers the tracker re-initializes
+// from the latest of them, so a genuine jump is followed instead of ignored.
+//
+// A track is only seeded from two consecutive samples within gate of each
+// other. A lone outlier right after a reset is replaced by the next sample
+// instead of becoming the state every genuine sample then misses.
+template <std::floating_point T = float>
+class alpha_beta_tracker
+{
+public:
+    explicit alpha_beta_tracker(T alpha = T(0.5),  // position correction gain
+                                T beta = T(0.1),   // velocity correction gain
+                                T gate = T(0.25),  // meters: max plausible residual
+                                uint32_t max_misses = 5) noexcept
+        : alpha_(alpha), beta_(beta), gate_(gate), max_misses_(max_misses) {}
+
+    // Feed a measurement (meters) taken at timestamp_us. Returns false if it
+    // was rejected by the gate.
+    bool update(T meters, int64_t timestamp_us) noexcept
+    {
+        if (!std::isfinite(meters))
+            return false;
+
+        if (samples_ == 0)
+        {
+            x_ = meters;
+            v_ = T(0);
+            last_us_ = timestamp_us;
+            samples_ = 1;
+            return true;
+        }
+
+        T dt = static_cast<T>(timestamp_us - last_us_) * T(1e-6);
+        if (dt <= T(0))
+            return false;
+
+        if (samples_ == 1)
+        {
+            // Seed candidate: keep the newer sample until two agree
+            if (std::fabs(meters - x_) > gate_)
+            {
+                x_ = meters;
+                last_us_ = timestamp_us;
+                return false;
+            }
+
+            // Second sample: seed the velocity from the two-point difference
+            v_ = (meters - x_) / dt;
+            x_ = meters;
+            last_us_ = timestamp_us;
+            samples_ = 2;
+            return true;
+        }
+
+        T x_pred = x_ + v_ * dt;
+        T residual = meters - x_pred;
+
+        if (std::fabs(residual) > gate_)
+        {
+            if (++misses_ >= max_misses_)
+            {
+                // Lost: this sample becomes the seed candidate of a new track
+                reset();
+                x_ = meters;
+                last_us_ = timestamp_us;
+                samples_ = 1;
+            }
+            return false;
+        }
+        misses_ = 0;
+
+        x_ = x_pred + alpha_ * residual;
+        v_ = v_ + (beta_ / dt) * residual;
+
+        last_us_ = timestamp_us;
+        ++samples_;
+        return true;
+    }
+
+    // Extrapolated distance at timestamp_us (meters)
+    T predict(int64_t timestamp_us) const noexcept
+    {
+        return x_ + v_ * static_cast<T>(timestamp_us - last_us_) * T(1e-6);
+    }
+
+    T distance() const noexcept { return x_; }  // meters
+    T velocity() const noexcept { return v_; }  // m/s, positive when receding
+    bool is_tracking() const noexcept { return samples_ >= 2; }
+
+    void reset() noexcept
+    {
+        samples_ = 0;
+        misses_ = 0;
+        x_ = T(0);
+        v_ = T(0);
+    }
+
+private:
+    T alpha_;
+    T beta_;
+    T gate_;
+    uint32_t max_misses_;
+
+    T x_ = T(0);
+    T v_ = T(0);
+    int64_t last_us_ = 0;
+    uint32_t samples_ = 0;
+    uint32_t misses_ = 0;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "track_reacquirer.hpp"
 #include <vector>
 #include <cstddef>
 #include <cstdint>
@@ -15,7 +16,8 @@ public:
     explicit batch_averager(size_t batch_size = 20,
                             double max_step = 0.05,     // meters: max plausible jump
                             double hampel_thresh = 3.0, // threshold in MAD units
-                            double trim_fraction = 0.1) noexcept;
+                            double trim_fraction = 0.1,
+                            size_t reacquire_count = 5) noexcept; // consistent out-of-step samples that re-seed the window
 
     // Add a new sample (meters)
     void add_sample(double meters) noexcept;
@@ -32,6 +34,12 @@ public:
     // Reset the averager to its initial state
     void reset() noexcept;
 
+    // Number of times the window was re-seeded after a genuine target move
+    uint32_t reacquisitions() const noexcept { return reacquirer_.reacquisitions(); }
+
+    // Rejected samples before the last re-seed (output latency after a move)
+    uint32_t last_settling_samples() const noexcept { return reacquirer_.last_settling_samples(); }
+
 private:
     //------------------------------------------
     // Core configuration parameters
@@ -49,10 +57,19 @@ private:
     std::vector<double> samples_; // Circular buffer storage
     size_t head_;                 // Next write index in the ring
     bool full_;                   // Flag indicating buffer has wrapped
+    size_t min_fill_;             // Samples needed before an average is produced
+
+    //------------------------------------------
+    // Step limiter re-acquisition
+    //------------------------------------------
+    track_reacquirer<double> reacquirer_;
 
     //------------------------------------------
     // Internal helpers
     //------------------------------------------
+    void push_sample(double meters) noexcept;
+    void update_average() noexcept;
+
     static double compute_trimmed_mean(std::vector<double> data,
                                        double trimFrac);
 
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "filter_stages.hpp"
+#include "sample_traits.hpp"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <tuple>
+#include <utility>
+
+template <typename S, typename T>
+concept untimed_filter_stage = requires(S &stage, T &value) {
+    { stage.process(value) } -> std::same_as<bool>;
+};
+
+template <typename S, typename T>
+concept timed_filter_stage = requires(S &stage, T &value, int64_t timestamp_us) {
+    { stage.process(value, timestamp_us) } -> std::same_as<bool>;
+};
+
+template <typename S, typename T>
+concept filter_stage = (untimed_filter_stage<S, T> || timed_filter_stage<S, T>) && requires(S &stage) {
+    { stage.reset() };
+};
+
+// Chain of filter stages composed at compile time, e.g.
+//
+//   filter_pipeline<float, step_limiter<float>, hampel<float, 31>,
+//                   trimmed_mean<float, 20>, ema<float>>
+//
+// Each sample runs through the stages in order until one drops it; the value
+// leaving the last stage becomes the output. Pipelines containing timed
+// stages (time_ema) are fed with add_sample(meters, timestamp_us); untimed
+// stages in them simply ignore the time.
+//
+// The accessors mirror batch_averager, but the filtering is not the same:
+// every stage sees one sample at a time. The hampel stage only drops the
+// sample in hand, and trimmed_mean averages whatever reached it, outliers
+// included once they are in its window. batch_averager filters the whole
+// window again for every output. With the same lengths, the two can differ
+// by tens of millimetres after outliers (see bench/averager_accuracy).
+template <typename T, filter_stage<T>... Stages>
+class filter_pipeline
+{
+public:
+    using value_type = T;
+    using traits = sample_traits<T>;
+
+    filter_pipeline() noexcept = default;
+    explicit filter_pipeline(Stages... stages) noexcept : stages_(std::move(stages)...) {}
+
+    // Add a new sample (meters); returns false if a stage dropped it
+    template <std::floating_point U>
+    bool add_sample(U meters) noexcept
+        requires(untimed_filter_stage<Stages, T> && ...)
+    {
+        return add_sample(meters, int64_t{0});
+    }
+
+    // Add a new sample (meters) taken at timestamp_us
+    template <std::floating_point U>
+    bool add_sample(U meters, int64_t timestamp_us) noexcept
+    {
+        if (!std::isfinite(meters))
+            return false;
+
+        T value = traits::from_meters(meters);
+        bool passed = std::apply([&value, timestamp_us](auto &...stage)
+                                 { return (run_stage(stage, value, timestamp_us) && ...); },
+                                 stages_);
+        if (passed)
+        {
+            output_ = value;
+            valid_ = true;
+        }
+        return passed;
+    }
+
+    // Query if an output has been produced
+    bool is_complete() const noexcept { return valid_; }
+
+    T average() const noexcept { return output_; }
+    double average_meters() const noexcept { return traits::to_meters(output_); }
+    uint16_t average_millimeters() const noexcept { return traits::to_millimeters(output_); }
+
+    void reset() noexcept
+    {
+        std::apply([](auto &...stage)
+                   { (stage.reset(), ...); },
+                   stages_);
+        output_ = T{};
+        valid_ = false;
+    }
+
+    template <size_t I>
+    auto &stage() noexcept { return std::get<I>(stages_); }
+
+private:
+    template <typename S>
+    static bool run_stage(S &stage, T &value, int64_t timestamp_us) noexcept
+    {
+        if constexpr (timed_filter_stage<S, T>)
+            return stage.process(value, timestamp_us);
+        else
+            return stage.process(value);
+    }
+
+    std::tuple<Stages...> stages_;
+    T output_{};
+    bool valid_ = false;
+};
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "sorted_window.hpp"
+#include "sample_traits.hpp"
+#include "track_reacquirer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+
+// Building blocks for filter_pipeline. A stage is any type with
+//   bool process(T &value) noexcept  // false drops the sample
+//   void reset() noexcept
+// It may rewrite value for the stages after it. Everything is resolved at
+// compile time, so a pipeline inlines into one straight-line function.
+//
+// Timed stages take the sample time instead, so their smoothing is set in
+// milliseconds and does not change with the frame rate:
+//   bool process(T &value, int64_t timestamp_us) noexcept
+
+// Rejects samples further than max_step from the last accepted one, once
+// warmup samples have been accepted. reacquire_count consistent rejected
+// samples in a row re-anchor the limiter on the new position.
+template <typename T>
+class step_limiter
+{
+public:
+    explicit step_limiter(double max_step = 0.05, size_t warmup = 1, size_t reacquire_count = 5) noexcept
+        : max_step_(sample_traits<T>::from_meters(max_step)), warmup_(warmup),
+          reacquirer_(reacquire_count, max_step_) {}
+
+    bool process(T &value) noexcept
+    {
+        if (accepted_ >= warmup_ && sample_traits<T>::abs(value - last_) > max_step_)
+        {
+            if (!reacquirer_.reject(value))
+                return false;
+        }
+        else
+        {
+            reacquirer_.accept();
+        }
+        last_ = value;
+        if (accepted_ < warmup_)
+            ++accepted_;
+        return true;
+    }
+
+    void reset() noexcept
+    {
+        accepted_ = 0;
+        reacquirer_.reset();
+    }
+
+    uint32_t reacquisitions() const noexcept { return reacquirer_.reacquisitions(); }
+    uint32_t last_settling_samples() const noexcept { return reacquirer_.last_settling_samples(); }
+
+private:
+    T max_step_;
+    T last_{};
+    size_t warmup_;
+    size_t accepted_ = 0;
+    track_reacquirer<T> reacquirer_;
+};
+
+// Streaming Hampel identifier over the last N samples: a sample further than
+// thresh scaled MADs from the window median is dropped once the window is full.
+template <typename T, size_t N>
+class hampel
+{
+public:
+    explicit hampel(double thresh = 3.0) noexcept
+        : scale_(sample_traits<T>::from_meters(thresh * 1.4826)) {}
+
+    bool process(T &value) noexcept
+    {
+        window_.push(value);
+        if (!window_.full())
+            return true;
+
+        T mad = window_.mad();
+        if (mad == T{})
+            return true;
+        return sample_traits<T>::abs(value - window_.median()) <= scale_ * mad;
+    }
+
+    void reset() noexcept { window_.clear(); }
+
+private:
+    T scale_;
+    sorted_window<T, N> window_;
+};
+
+// Replaces the sample with the mean of the last N samples after trimming
+// trim_fraction of them from each end.
+template <typename T, size_t N>
+class trimmed_mean
+{
+public:
+    explicit trimmed_mean(double trim_fraction = 0.1) noexcept : trim_fraction_(trim_fraction) {}
+
+    bool process(T &value) noexcept
+    {
+        window_.push(value);
+        size_t len = window_.size();
+        size_t trim = static_cast<size_t>(trim_fraction_ * len);
+        if (len <= 2 * trim)
+        {
+            value = window_.median();
+            return true;
+        }
+        value = sample_traits<T>::mean(window_.sum(trim, len - trim), len - 2 * trim);
+        return true;
+    }
+
+    void reset() noexcept { window_.clear(); }
+
+private:
+    double trim_fraction_;
+    sorted_window<T, N> window_;
+};
+
+// First-order exponential smoothing, y += alpha * (x - y).
+template <typename T>
+class ema
+{
+public:
+    explicit ema(double alpha = 0.2) noexcept : alpha_(sample_traits<T>::from_meters(alpha)) {}
+
+    bool process(T &value) noexcept
+    {
+        if (!primed_)
+        {
+            state_ = value;
+            primed_ = true;
+        }
+        else
+        {
+            state_ = state_ + alpha_ * (value - state_);
+        }
+        value = state_;
+        return true;
+    }
+
+    void reset() noexcept { primed_ = false; }
+
+private:
+    T alpha_;
+    T state_{};
+    bool primed_ = false;
+};
+
+// EMA with a time constant instead of a per-sample weight. Each sample is
+// blended in with alpha = 1 - exp(-dt / tau), which is exact for irregular
+// spacing: a late frame moves the output further than a prompt one, and the
+// step response reaches 63 % after tau_ms at any frame rate. A sample that
+// is not newer than the previous one carries no elapsed time, so it leaves
+// the output where it was.
+template <typename T>
+class time_ema
+{
+public:
+    explicit time_ema(double tau_ms = 500.0) noexcept : tau_us_(tau_ms * 1000.0) {}
+
+    bool process(T &value, int64_t timestamp_us) noexcept
+    {
+        if (!primed_ || tau_us_ <= 0.0)
+        {
+            state_ = value;
+            primed_ = true;
+            last_us_ = timestamp_us;
+        }
+        else if (timestamp_us > last_us_)
+        {
+            const float dt = static_cast<float>(timestamp_us - last_us_);
+            const T alpha = sample_traits<T>::from_meters(1.0f - std::exp(-dt / static_cast<float>(tau_us_)));
+            state_ = state_ + alpha * (value - state_);
+            last_us_ = timestamp_us;
+        }
+        value = state_;
+        return true;
+    }
+
+    void set_time_constant(double tau_ms) noexcept { tau_us_ = tau_ms * 1000.0; }
+
+    void reset() noexcept { primed_ = false; }
+
+private:
+    double tau_us_;
+    T state_{};
+    int64_t last_us_ = 0;
+    bool primed_ = false;
+};
@@ -0,0 +1,399 @@
+#pragma once
+
+#include "sorted_window.hpp"
+#include "sample_traits.hpp"
+#include "track_reacquirer.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <concepts>
+
+// Same filtering as batch_averager (step limiter, Hampel filter, trimmed mean)
+// with the window size fixed at compile time. All storage lives in the object,
+// so add_sample() never touches the heap. The window is kept sorted as samples
+// arrive, so the Hampel inliers are a contiguous slice of it and no per-sample
+// sort is needed. T selects the arithmetic: double (reference), float or q16_16.
+//
+// With Weighted, samples also carry the sensor's reported magnitude: samples
+// below magnitude_floor are dropped and the trimmed mean weights the rest by
+// how far they are above the floor. The median/MAD outlier test is unweighted.
+//
+// N is the capacity; the active window length and the thresholds can be
+// retuned at runtime without losing the samples that still fit.
+//
+// Every sample enters the window and its running sums, but the Hampel range
+// and trimmed mean can be evaluated only on every k-th sample (output
+// decimation), so the robust statistics run at the output rate while still
+// seeing each raw sample.
+//
+// With Timed, samples carry their timestamp and set_max_age_ms() bounds the
+// window in time as well as in samples: before each sample is added, the
+// ones older than the limit are evicted, so the window keeps spanning the
+// same time when frames come late or are dropped. Once samples have aged
+// out the window counts as complete at whatever length it has. The newest
+// sample is always kept, so the step limiter still has a reference after a
+// gap in the data.
+template <size_t N, typename T = double, bool Weighted = false, bool Timed = false>
+class fixed_batch_averager
+{
+public:
+    using value_type = T;
+    using traits = sample_traits<T>;
+
+    // Constructor
+    explicit fixed_batch_averager(double max_step = 0.05,     // meters: max plausible jump
+                                  double hampel_thresh = 3.0, // threshold in MAD units
+                                  double trim_fraction = 0.1,
+                                  size_t reacquire_count = 5,   // consistent out-of-step samples that re-seed the window
+                                  uint16_t magnitude_floor = 0) noexcept; // weighted mode: weakest magnitude accepted
+
+    // Add a new sample (meters)
+    template <std::floating_point U>
+    void add_sample(U meters) noexcept { add_sample(meters, magnitude_floor_); }
+
+    // Add a new sample (meters) with its signal magnitude; returns false if
+    // the sample was dropped for being non-finite or below the floor.
+    template <std::floating_point U>
+    bool add_sample(U meters, uint16_t magnitude) noexcept { return add_at(meters, magnitude, last_us_); }
+
+    // As above, for a sample taken at timestamp_us
+    template <std::floating_point U>
+    bool add_sample(U meters, uint16_t magnitude, int64_t timestamp_us) noexcept
+        requires Timed
+    {
+        return add_at(meters, magnitude, timestamp_us);
+    }
+
+    // Query if the buffer is full, or spans the whole age limit
+    bool is_complete() const noexcept { return window_.full() || aged_out_; }
+
+    // Get current averaged value (in meters)
+    double average_meters() const noexcept { return traits::to_meters(curr_avg_m_); }
+
+    // Get current averaged value in the native sample type
+    T average() const noexcept { return curr_avg_m_; }
+
+    // Get averaged value converted to millimeters (clamped to uint16_t)
+    uint16_t average_millimeters() const noexcept;
+
+    // Reset the averager to its initial state
+    void reset() noexcept;
+
+    static constexpr size_t capacity() noexcept { return N; }
+
+    // Change the active window length (1..N). Shrinking keeps the newest
+    // samples; growing keeps publishing while the window refills.
+    bool set_window(size_t length) noexcept;
+
+    // Change the step limit, Hampel threshold and trim fraction
+    void set_limits(double max_step, double hampel_thresh, double trim_fraction) noexcept;
+
+    // Change how many consistent out-of-step samples re-seed the window
+    // (0 disables re-acquisition, at most max_reacquire_count)
+    void set_reacquire_count(size_t count) noexcept { reacquirer_.set_run_length(count); }
+    size_t reacquire_count() const noexcept { return reacquirer_.run_length(); }
+    static constexpr size_t max_reacquire_count = track_reacquirer<T>::max_run_length;
+
+    // Evict samples older than max_age_ms before each new one (0 disables)
+    void set_max_age_ms(uint32_t max_age_ms) noexcept
+        requires Timed
+    {
+        max_age_us_ = int64_t(max_age_ms) * 1000;
+    }
+    uint32_t max_age_ms() const noexcept { return static_cast<uint32_t>(max_age_us_ / 1000); }
+
+    // Recompute the average every `every` accepted samples (1 = every sample)
+    void set_output_decimation(size_t every) noexcept;
+    size_t output_decimation() const noexcept { return output_every_; }
+
+    size_t window() const noexcept { return window_.length(); }
+    double max_step() const noexcept { return traits::to_meters(max_step_); }
+    double hampel_threshold() const noexcept { return hampel_thresh_; }
+    double trim_fraction() const noexcept { return trim_fraction_; }
+
+    // Number of times the window was re-seeded after a genuine target move
+    uint32_t reacquisitions() const noexcept { return reacquirer_.reacquisitions(); }
+
+    // Rejected samples before the last re-seed (output latency after a move)
+    uint32_t last_settling_samples() const noexcept { return reacquirer_.last_settling_samples(); }
+
+    // Samples rejected since the last accepted one; 0 when on track
+    uint32_t pending_rejections() const noexcept { return reacquirer_.pending_rejections(); }
+
+    // Samples dropped for a magnitude below the floor
+    uint32_t weak_samples() const noexcept { return weak_samples_; }
+
+private:
+    //------------------------------------------
+    // Core configuration parameters
+    //------------------------------------------
+    size_t count_;         // Total samples processed
+    T curr_avg_m_;         // Latest computed average in meters
+    T max_step_;           // Max physical jump allowed between samples
+    double hampel_thresh_; // Hampel outlier threshold (in MAD units)
+    T hampel_scale_;       // Hampel threshold times the Gaussian MAD factor
+    double trim_fraction_; // Fraction to trim from both ends for trimmed mean
+    uint16_t magnitude_floor_; // Weakest magnitude accepted (weighted mode)
+    uint32_t weak_samples_;    // Samples dropped below the floor
+    size_t output_every_;      // Samples per average evaluation
+    size_t since_output_;      // Samples pushed since the last evaluation
+    bool has_average_;         // An average has been computed since reset
+    int64_t max_age_us_;       // Age limit of the window (timed mode, 0 = none)
+    int64_t last_us_;          // Timestamp of the latest sample (timed mode)
+    bool aged_out_;            // Samples left the window by age since the last re-seed
+
+    //------------------------------------------
+    // Sample window (arrival order + value order)
+    //------------------------------------------
+    sorted_window<T, N, Weighted, Timed> window_;
+    size_t min_fill_; // Samples needed before an average is produced
+
+    //------------------------------------------
+    // Step limiter re-acquisition
+    //------------------------------------------
+    track_reacquirer<T> reacquirer_;
+
+    //------------------------------------------
+    // Internal helpers
+    //------------------------------------------
+    template <std::floating_point U>
+    bool add_at(U meters, uint16_t magnitude, int64_t timestamp_us) noexcept;
+    void expire(int64_t now_us) noexcept;
+    void push_sample(T sample, uint16_t weight, int64_t timestamp_us) noexcept;
+    void update_average() noexcept;
+    void hampel_range(size_t &first, size_t &last) const noexcept;
+    T compute_trimmed_mean(size_t first, size_t last) const noexcept;
+};
+
+// Scale factor for Gaussian equivalence of the MAD
+inline constexpr double hampel_mad_scale = 1.4826;
+
+template <size_t N, typename T, bool Weighted, bool Timed>
+fixed_batch_averager<N, T, Weighted, Timed>::fixed_batch_averager(double max_step,
+                                                           double hampel_thresh,
+                                                           double trim_fraction,
+                                                           size_t reacquire_count,
+                                                           uint16_t magnitude_floor) noexcept
+    : count_(0),
+      curr_avg_m_(traits::from_meters(0.0)),
+      max_step_(traits::from_meters(max_step)),
+      hampel_thresh_(hampel_thresh),
+      hampel_scale_(traits::from_meters(hampel_thresh * hampel_mad_scale)),
+      trim_fraction_(trim_fraction),
+      magnitude_floor_(magnitude_floor),
+      weak_samples_(0),
+      output_every_(1),
+      since_output_(0),
+      has_average_(false),
+      max_age_us_(0),
+      last_us_(0),
+      aged_out_(false),
+      min_fill_(N),
+      reacquirer_(reacquire_count, max_step_)
+{
+}
+
+template <size_t N, typename T, bool Weighted, bool Timed>
+template <std::floating_point U>
+bool fixed_batch_averager<N, T, Weighted, Timed>::add_at(U meters, uint16_t magnitude, int64_t timestamp_us) noexcept
+{
+    if (!std::isfinite(meters))
+        return false;
+
+    if (magnitude < magnitude_floor_)
+    {
+        ++weak_samples_;
+        return false;
+    }
+
+    if constexpr (Timed)
+        expire(timestamp_us);
+
+    // Weight by magnitude above the floor; every accepted sample counts
+    const uint16_t weight = Weighted ? static_cast<uint16_t>(std::min<uint32_t>(magnitude - magnitude_floor_ + 1u, 0xFFFF)) : 1;
+    const T sample = traits::from_meters(meters);
+
+    // Step-change limiter
+    if (is_complete() && traits::abs(sample - window_.newest()) > max_step_)
+    {
+        if (!reacquirer_.reject(sample, weight, timestamp_us))
+            return true;
+
+        // The target really moved: re-seed the window with the consistent
+        // run and publish from the partial window until it refills.
+        window_.clear();
+        aged_out_ = false;
+        const uint16_t *run_weight = reacquirer_.run_weights();
+        const int64_t *run_stamp = reacquirer_.run_stamps();
+        for (const T *it = reacquirer_.run_begin(); it != reacquirer_.run_end(); ++it)
+            window_.push(*it, *run_weight++, *run_stamp++);
+        count_ += reacquirer_.run_length();
+        min_fill_ = std::min(reacquirer_.run_length(), window_.length());
+        update_average();
+        return true;
+    }
+
+    reacquirer_.accept();
+    push_sample(sample, weight, timestamp_us);
+    return true;
+}
+
+template <size_t N, typename T, bool Weighted, bool Timed>
+void fixed_batch_averager<N, T, Weighted, Timed>::expire(int64_t now_us) noexcept
+{
+    last_us_ = now_us;
+    if (max_age_us_ <= 0)
+        return;
+
+    bool evicted = false;
+    while (window_.size() > 1 && window_.oldest_stamp() < now_us - max_age_us_)
+    {
+        window_.pop_oldest();
+        evicted = true;
+    }
+
+    // The window now covers the whole age limit: publish from what is left
+    if (evicted)
+    {
+        aged_out_ = true;
+        min_fill_ = std::min(min_fill_, window_.size());
+    }
+}
+
+template <size_t N, typename T, bool Weighted, bool Timed>
+void fixed_batch_averager<N, T, Weighted, Timed>::push_sample(T sample, uint16_t weight, int64_t timestamp_us) noexcept
+{
+    window_.push(sample, weight, timestamp_us);
+    ++count_;
+
+    // The first average is produced as soon as the window fills, then once
+    // per decimation period
+    if (++since_output_ >= output_every_ || !has_average_)
+        update_average();
+    if (window_.full())
+        min_fill_ = window_.length();
+}
+
+template <size_t N, typename T, bool Weighted, bool Timed>
+bool fixed_batch_averager<N, T, Weighted, Timed>::set_window(size_t length) noexcept
+{
+    if (length == 0 || length > N)
+        return false;
+
+    // Keep publishing if an average is already being produced; otherwise
+    // wait for the new length to fill as on start-up.
+    const bool publishing = count_ > 0 && window_.size() >= min_fill_;
+    window_.set_length(length);
+    min_fill_ = publishing ? std::min(window_.size(), length) : length;
+
+    update_average();
+    return true;
+}
+
+template <size_t N, typename T, bool Weighted, bool Timed>
+void fixed_batch_averager<N, T, Weighted, Timed>::set_limits(double max_step, double hampel_thresh, double trim_fraction) noexcept
+{
+    max_step_ = traits::from_meters(max_step);
+    hampel_thresh_ = hampel_thresh;
+    hampel_scale_ = traits::from_meters(hampel_thresh * hampel_mad_scale);
+    trim_fraction_ = trim_fraction;
+    reacquirer_.set_max_step(max_step_);
+
+    update_average();
+}
+
+template <size_t N, typename T, bool Weighted, bool Timed>
+void fixed_batch_averager<N, T, Weighted, Timed>::set_output_decimation(size_t every) noexcept
+{
+    output_every_ = every > 0 ? every : 1;
+    since_output_ = 0;
+}
+
+template <size_t N, typename T, bool Weighted, bool Timed>
+void fixed_batch_averager<N, T, Weighted, Timed>::update_average() noexcept
+{
+    if (window_.size() < min_fill_)
+        return;
+
+    size_t first = 0;
+    size_t last = 0;
+    hampel_range(first, last);
+    curr_avg_m_ = compute_trimmed_mean(first, last);
+    has_average_ = true;
+    since_output_ = 0;
+}
+
+template <size_t N, typename T, bool Weighted, bool Timed>
+uint16_t fixed_batch_averager<N, T, Weighted, Timed>::average_millimeters() const noexcept
+{
+    return traits::to_millimeters(curr_avg_m_);
+}
+
+template <size_t N, typename T, bool Weighted, bool Timed>
+void fixed_batch_averager<N, T, Weighted, Timed>::reset() noexcept
+{
+    count_ = 0;
+    curr_avg_m_ = traits::from_meters(0.0);
+    window_.clear();
+    min_fill_ = window_.length();
+    weak_samples_ = 0;
+    since_output_ = 0;
+    has_average_ = false;
+    last_us_ = 0;
+    aged_out_ = false;
+    reacquirer_.reset();
+}
+
+//----------------------------------------------
+// Hampel filter: the inliers |x - median| <= k * thresh * MAD form the sorted
+// slice [first, last) of the window.
+//----------------------------------------------
+template <size_t N, typename T, bool Weighted, bool Timed>
+void fixed_batch_averager<N, T, Weighted, Timed>::hampel_range(size_t &first, size_t &last) const noexcept
+{
+    T median = window_.median();
+    T mad = window_.mad();
+
+    if (mad == T{})
+    {
+        first = 0;
+        last = window_.size();
+        return;
+    }
+
+    T limit = hampel_scale_ * mad;
+    window_.range(median - limit, median + limit, first, last);
+}
+
+//----------------------------------------------
+// Trimmed mean over the sorted slice [first, last). The sum comes from the
+// window's running total, so the cost is O(trim + outliers), not O(N). In
+// weighted mode it is the magnitude-weighted mean of the same slice.
+//----------------------------------------------
+template <size_t N, typename T, bool Weighted, bool Timed>
+T fixed_batch_averager<N, T, Weighted, Timed>::compute_trimmed_mean(size_t first, size_t last) const noexcept
+{
+    size_t len = last - first;
+    if (len == 0)
+        return window_.median();
+
+    size_t trim = static_cast<size_t>(trim_fraction_ * len);
+    size_t start = first + trim;
+    size_t end = last - trim;
+
+    if (end <= start)
+        return window_.sorted(first + len / 2); // fallback: median
+
+    if constexpr (Weighted)
+    {
+        typename traits::accum_type sum_wx{};
+        typename traits::accum_type sum_w{};
+        window_.weighted_sum(start, end, sum_wx, sum_w);
+        return traits::ratio(sum_wx, sum_w);
+    }
+    else
+    {
+        return traits::mean(window_.sum(start, end), end - start);
+    }
+}
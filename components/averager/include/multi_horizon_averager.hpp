@@ -0,0 +1,209 @@
+#pragma once
+
+#include "sample_traits.hpp"
+#include "track_reacquirer.hpp"
+#include "filter_stages.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <concepts>
+
+// True if every horizon is non-zero and longer than the one before it
+template <size_t Count>
+constexpr bool horizons_ascending(const std::array<size_t, Count> &lengths) noexcept
+{
+    for (size_t i = 0; i < Count; ++i)
+        if (lengths[i] == 0 || (i > 0 && lengths[i] <= lengths[i - 1]))
+            return false;
+    return true;
+}
+
+// Several moving averages over the same sample stream, e.g. a short window for
+// fast response next to a long one for stability. All horizons share one ring
+// sized for the longest; each keeps a running sum updated with the sample
+// entering it and the one leaving it, so add_sample() is O(horizon count)
+// regardless of the window lengths.
+//
+// Outliers are removed once, in front of all horizons: a step limiter with
+// re-acquisition, then a Hampel identifier over the last hampel_window
+// samples. The horizons themselves are plain means. A per-horizon trimmed
+// mean would need a sorted window for every horizon, which is the cost this
+// class exists to avoid, so the output is not the same as a batch_averager
+// of the same length.
+//
+// The gate is much weaker than the filtering it replaces. batch_averager runs
+// Hampel over its whole window for every output, so an outlier is judged
+// against 20 or more neighbours and dropped even after it entered the window.
+// Here each sample is judged once, against the last hampel_window samples (the
+// shortest horizon, at least 5). Clustered outliers or a few noisy frames
+// widen that MAD enough to let spikes through; once through, they stay in
+// every horizon until they age out. On the synthetic trace of
+// bench/averager_accuracy that costs up to ~28 mm on the 5-sample horizon. Use
+// fixed_batch_averager where outliers are frequent.
+//
+// Horizons are window lengths in samples, in ascending order.
+template <typename T, size_t... Horizons>
+class multi_horizon_averager
+{
+    static_assert(sizeof...(Horizons) > 0, "at least one horizon is needed");
+
+    static constexpr std::array<size_t, sizeof...(Horizons)> lengths_{Horizons...};
+    static_assert(horizons_ascending(lengths_), "horizons must be non-zero and strictly ascending");
+
+public:
+    using value_type = T;
+    using traits = sample_traits<T>;
+    using accum_type = typename traits::accum_type;
+
+    static constexpr size_t horizon_count = sizeof...(Horizons);
+    static constexpr size_t capacity = lengths_.back();
+
+    // Outlier gate window: the shortest horizon, so the gate follows the
+    // target as fast as the fastest average, but not below 5 samples
+    static constexpr size_t hampel_window = lengths_.front() < 5 ? 5 : lengths_.front();
+
+    // Pushes between exact re-summations of the running sums
+    static constexpr uint32_t resum_period = 256;
+
+    explicit multi_horizon_averager(double max_step = 0.05,     // meters: max plausible jump
+                                    double hampel_thresh = 3.0, // threshold in MAD units, 0 disables the gate
+                                    size_t reacquire_count = 5) noexcept // consistent out-of-step samples that re-seed
+        : max_step_(traits::from_meters(max_step)),
+          reacquirer_(reacquire_count, max_step_),
+          gate_(hampel_thresh),
+          gate_enabled_(hampel_thresh > 0.0)
+    {
+    }
+
+    // Add a new sample (meters)
+    template <std::floating_point U>
+    void add_sample(U meters) noexcept
+    {
+        if (!std::isfinite(meters))
+            return;
+
+        const T sample = traits::from_meters(meters);
+
+        // Step-change limiter
+        if (size_ > 0 && traits::abs(sample - newest()) > max_step_)
+        {
+            if (!reacquirer_.reject(sample))
+                return;
+
+            // The target really moved: restart every horizon and the gate
+            // from the run
+            clear();
+            gate_.reset();
+            for (const T *it = reacquirer_.run_begin(); it != reacquirer_.run_end(); ++it)
+            {
+                T seeded = *it;
+                gate_.process(seeded);
+                push(*it);
+            }
+            return;
+        }
+
+        reacquirer_.accept();
+
+        // Hampel gate: the sample still enters the gate window, but an
+        // outlier never reaches the horizons
+        T gated = sample;
+        if (gate_enabled_ && !gate_.process(gated))
+        {
+            ++outliers_;
+            return;
+        }
+        push(sample);
+    }
+
+    // Length of horizon i in samples
+    static constexpr size_t length(size_t i) noexcept { return lengths_[i]; }
+
+    // Query if horizon i has seen a full window of samples
+    bool is_complete(size_t i) const noexcept { return size_ >= lengths_[i]; }
+
+    // Average over horizon i, or over all samples while it is still filling
+    T average(size_t i) const noexcept
+    {
+        const size_t n = std::min(size_, lengths_[i]);
+        return n == 0 ? traits::from_meters(0.0) : traits::mean(sums_[i], n);
+    }
+
+    double average_meters(size_t i) const noexcept { return traits::to_meters(average(i)); }
+
+    uint16_t average_millimeters(size_t i) const noexcept { return traits::to_millimeters(average(i)); }
+
+    void reset() noexcept
+    {
+        clear();
+        reacquirer_.reset();
+        gate_.reset();
+        outliers_ = 0;
+    }
+
+    uint32_t reacquisitions() const noexcept { return reacquirer_.reacquisitions(); }
+    uint32_t outliers() const noexcept { return outliers_; }
+    uint32_t last_settling_samples() const noexcept { return reacquirer_.last_settling_samples(); }
+
+private:
+    T newest() const noexcept { return ring_[(head_ + capacity - 1) % capacity]; }
+
+    // Sample that was pushed `back` pushes ago (1 is the newest)
+    T back(size_t back) const noexcept { return ring_[(head_ + capacity - back) % capacity]; }
+
+    void push(T sample) noexcept
+    {
+        // Each horizon drops the sample that falls out of its window; read
+        // them all before the ring slot for the longest one is overwritten.
+        for (size_t i = 0; i < horizon_count; ++i)
+        {
+            if (size_ >= lengths_[i])
+                sums_[i] -= traits::widen(back(lengths_[i]));
+            sums_[i] += traits::widen(sample);
+        }
+
+        ring_[head_] = sample;
+        head_ = (head_ + 1) % capacity;
+        if (size_ < capacity)
+            ++size_;
+
+        if (++since_resum_ >= resum_period)
+            resum();
+    }
+
+    void clear() noexcept
+    {
+        head_ = 0;
+        size_ = 0;
+        sums_.fill(accum_type{});
+        since_resum_ = 0;
+    }
+
+    // Recompute the running sums exactly; nested horizons share the walk.
+    void resum() noexcept
+    {
+        accum_type acc{};
+        size_t walked = 0;
+        for (size_t i = 0; i < horizon_count; ++i)
+        {
+            const size_t n = std::min(size_, lengths_[i]);
+            for (; walked < n; ++walked)
+                acc += traits::widen(back(walked + 1));
+            sums_[i] = acc;
+        }
+        since_resum_ = 0;
+    }
+
+    std::array<T, capacity> ring_{};
+    std::array<accum_type, horizon_count> sums_{};
+    size_t head_ = 0;
+    size_t size_ = 0;
+    uint32_t since_resum_ = 0;
+    T max_step_;
+    track_reacquirer<T> reacquirer_;
+    hampel<T, hampel_window> gate_;
+    bool gate_enabled_;
+    uint32_t outliers_ = 0;
+};
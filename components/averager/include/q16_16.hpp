@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+// Signed Q16.16 fixed-point value: 16 integer bits, 16 fraction bits
+// (~15 um resolution, +/-32 km range when used for meters). Only the
+// operations the averaging pipeline needs are provided.
+struct q16_16
+{
+    int32_t raw = 0;
+
+    static constexpr int frac_bits = 16;
+    static constexpr int32_t one = int32_t(1) << frac_bits;
+
+    static constexpr q16_16 from_raw(int32_t raw) noexcept { return q16_16{raw}; }
+
+    static q16_16 from_double(double value) noexcept
+    {
+        return q16_16{static_cast<int32_t>(std::lround(value * one))};
+    }
+
+    static q16_16 from_float(float value) noexcept
+    {
+        return q16_16{static_cast<int32_t>(std::lroundf(value * static_cast<float>(one)))};
+    }
+
+    constexpr double to_double() const noexcept { return static_cast<double>(raw) / one; }
+
+    friend constexpr q16_16 operator+(q16_16 a, q16_16 b) noexcept { return q16_16{a.raw + b.raw}; }
+    friend constexpr q16_16 operator-(q16_16 a, q16_16 b) noexcept { return q16_16{a.raw - b.raw}; }
+
+    friend constexpr q16_16 operator*(q16_16 a, q16_16 b) noexcept
+    {
+        return q16_16{static_cast<int32_t>((static_cast<int64_t>(a.raw) * b.raw) >> frac_bits)};
+    }
+
+    friend constexpr bool operator==(q16_16 a, q16_16 b) noexcept { return a.raw == b.raw; }
+    friend constexpr bool operator!=(q16_16 a, q16_16 b) noexcept { return a.raw != b.raw; }
+    friend constexpr bool operator<(q16_16 a, q16_16 b) noexcept { return a.raw < b.raw; }
+    friend constexpr bool operator<=(q16_16 a, q16_16 b) noexcept { return a.raw <= b.raw; }
+    friend constexpr bool operator>(q16_16 a, q16_16 b) noexcept { return a.raw > b.raw; }
+    friend constexpr bool operator>=(q16_16 a, q16_16 b) noexcept { return a.raw >= b.raw; }
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "q16_16.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <type_traits>
+
+// Arithmetic the averaging pipeline needs from its sample type. double is the
+// reference, float maps onto the ESP32 single-precision FPU and q16_16 uses
+// integer instructions only.
+template <typename T>
+struct sample_traits
+{
+    static_assert(std::is_floating_point_v<T>, "unsupported sample type");
+
+    using accum_type = T;
+
+    template <typename U>
+    static T from_meters(U meters) noexcept { return static_cast<T>(meters); }
+
+    static double to_meters(T value) noexcept { return static_cast<double>(value); }
+
+    static T abs(T value) noexcept { return std::fabs(value); }
+
+    static accum_type widen(T value) noexcept { return value; }
+
+    static T mean(accum_type sum, size_t count) noexcept { return sum / static_cast<T>(count); }
+
+    static accum_type weigh(T value, uint16_t weight) noexcept { return value * static_cast<T>(weight); }
+    static accum_type weight(uint16_t weight) noexcept { return static_cast<T>(weight); }
+    static T ratio(accum_type sum_wx, accum_type sum_w) noexcept { return sum_wx / sum_w; }
+
+    static uint16_t to_millimeters(T meters) noexcept
+    {
+        T mm = meters * T(1000);
+        if (mm < T(0))
+            return 0;
+        if (mm > T(65535))
+            return 0xFFFF;
+        return static_cast<uint16_t>(mm + T(0.5));
+    }
+};
+
+template <>
+struct sample_traits<q16_16>
+{
+    using accum_type = int64_t; // raw Q16.16 units, wide enough for any window
+
+    static q16_16 from_meters(double meters) noexcept { return q16_16::from_double(meters); }
+    static q16_16 from_meters(float meters) noexcept { return q16_16::from_float(meters); }
+
+    static double to_meters(q16_16 value) noexcept { return value.to_double(); }
+
+    static q16_16 abs(q16_16 value) noexcept { return q16_16::from_raw(value.raw < 0 ? -value.raw : value.raw); }
+
+    static accum_type widen(q16_16 value) noexcept { return value.raw; }
+
+    static q16_16 mean(accum_type sum, size_t count) noexcept
+    {
+        const int64_t n = static_cast<int64_t>(count);
+        const int64_t half = sum < 0 ? -n / 2 : n / 2;
+        return q16_16::from_raw(static_cast<int32_t>((sum + half) / n));
+    }
+
+    static accum_type weigh(q16_16 value, uint16_t weight) noexcept { return static_cast<int64_t>(value.raw) * weight; }
+    static accum_type weight(uint16_t weight) noexcept { return weight; }
+
+    static q16_16 ratio(accum_type sum_wx, accum_type sum_w) noexcept
+    {
+        const int64_t half = sum_wx < 0 ? -sum_w / 2 : sum_w / 2;
+        return q16_16::from_raw(static_cast<int32_t>((sum_wx + half) / sum_w));
+    }
+
+    static uint16_t to_millimeters(q16_16 meters) noexcept
+    {
+        if (meters.raw <= 0)
+            return 0;
+        int64_t mm = (static_cast<int64_t>(meters.raw) * 1000 + (q16_16::one / 2)) >> q16_16::frac_bits;
+        return mm > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(mm);
+    }
+};
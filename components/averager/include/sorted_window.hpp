@@ -0,0 +1,290 @@
+#pragma once
+
+#include "sample_traits.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+// Sliding window of the last N samples kept both in arrival order (ring) and
+// in value order (sorted array). push() is O(N) worst case (binary search plus
+// one memmove for the evicted and one for the inserted sample); median is O(1)
+// and MAD is an O(N/2) merge walk outwards from the median, with no sorting.
+// A running total makes the sum of any sorted slice cost O(min(slice, rest)).
+//
+// With Weighted, every sample carries a uint16_t weight that travels with it
+// through the sorted order, and weighted slice sums are maintained as well.
+// Order statistics (median, MAD, range) stay unweighted.
+//
+// With Timed, every sample also carries a timestamp, so the owner can evict
+// samples by age (pop_oldest() while oldest_stamp() is too old).
+//
+// The active length can be changed at runtime up to the capacity N; samples
+// that no longer fit are evicted oldest first and the rest are kept.
+template <typename T, size_t N, bool Weighted = false, bool Timed = false>
+class sorted_window
+{
+    static_assert(N > 0, "sorted_window needs a non-empty capacity");
+
+public:
+    using traits = sample_traits<T>;
+    using accum_type = typename traits::accum_type;
+
+    // Pushes between exact re-summations of the running totals, bounding the
+    // rounding drift of floating-point add/subtract updates.
+    static constexpr uint32_t resum_period = 256;
+
+    // Append a sample, evicting the oldest one once the window is full.
+    void push(T value, uint16_t weight = 1, int64_t stamp = 0) noexcept
+    {
+        if (size_ == length_)
+            evict_oldest();
+
+        ring_[head_] = value;
+        if constexpr (Weighted)
+            ring_weights_[head_] = weight;
+        if constexpr (Timed)
+            ring_stamps_[head_] = stamp;
+        else
+            (void)stamp;
+        head_ = (head_ + 1) % N;
+        ++size_;
+        insert_sorted(value, weight);
+
+        total_ += traits::widen(value);
+        if constexpr (Weighted)
+        {
+            total_wx_ += traits::weigh(value, weight);
+            total_w_ += traits::weight(weight);
+        }
+        if (++since_resum_ >= resum_period)
+            resum();
+    }
+
+    void clear() noexcept
+    {
+        head_ = 0;
+        size_ = 0;
+        total_ = accum_type{};
+        total_wx_ = accum_type{};
+        total_w_ = accum_type{};
+        since_resum_ = 0;
+    }
+
+    // Evict the oldest sample, if any
+    void pop_oldest() noexcept
+    {
+        if (size_ > 0)
+            evict_oldest();
+    }
+
+    // Timestamp the oldest sample was pushed with
+    int64_t oldest_stamp() const noexcept
+        requires Timed
+    {
+        return ring_stamps_[(head_ + N - size_) % N];
+    }
+
+    // Change the active length (clamped to 1..N), keeping the newest samples
+    void set_length(size_t length) noexcept
+    {
+        length_ = std::clamp<size_t>(length, 1, N);
+        while (size_ > length_)
+            evict_oldest();
+    }
+
+    size_t length() const noexcept { return length_; }
+    size_t size() const noexcept { return size_; }
+    bool full() const noexcept { return size_ == length_; }
+    bool empty() const noexcept { return size_ == 0; }
+    static constexpr size_t capacity() noexcept { return N; }
+
+    // Chronological access: 0 is the oldest sample in the window.
+    T at(size_t i) const noexcept { return ring_[(head_ + N - size_ + i) % N]; }
+    T newest() const noexcept { return ring_[(head_ + N - 1) % N]; }
+
+    // Value-ordered access: 0 is the smallest sample in the window.
+    T sorted(size_t i) const noexcept { return sorted_[i]; }
+    const T *sorted_begin() const noexcept { return sorted_.data(); }
+    const T *sorted_end() const noexcept { return sorted_.data() + size_; }
+
+    // Upper median (element size/2 of the sorted window).
+    T median() const noexcept { return sorted_[size_ / 2]; }
+
+    // Element size/2 of the sorted absolute deviations from median().
+    T mad() const noexcept
+    {
+        if (size_ == 0)
+            return T{};
+
+        const size_t mid = size_ / 2;
+        const T m = sorted_[mid];
+        size_t left = mid + 1; // next left candidate is sorted_[left - 1]
+        size_t right = mid + 1;
+        T dev{};
+
+        for (size_t taken = 0; taken <= mid; ++taken)
+        {
+            if (left > 0 && (right >= size_ || m - sorted_[left - 1] <= sorted_[right] - m))
+                dev = m - sorted_[--left];
+            else
+                dev = sorted_[right++] - m;
+        }
+        return dev;
+    }
+
+    // Sum of all samples in the window.
+    accum_type total() const noexcept { return total_; }
+
+    // Sum of the sorted slice [first, last), taken directly or as the total
+    // minus the outside, whichever touches fewer elements.
+    accum_type sum(size_t first, size_t last) const noexcept
+    {
+        accum_type acc{};
+        if (2 * (last - first) <= size_)
+        {
+            for (size_t i = first; i < last; ++i)
+                acc += traits::widen(sorted_[i]);
+            return acc;
+        }
+
+        for (size_t i = 0; i < first; ++i)
+            acc += traits::widen(sorted_[i]);
+        for (size_t i = last; i < size_; ++i)
+            acc += traits::widen(sorted_[i]);
+        return total_ - acc;
+    }
+
+    // Weighted sum and total weight of the sorted slice [first, last).
+    void weighted_sum(size_t first, size_t last, accum_type &sum_wx, accum_type &sum_w) const noexcept
+        requires Weighted
+    {
+        accum_type wx{};
+        accum_type w{};
+        const bool direct = 2 * (last - first) <= size_;
+        auto add = [&](size_t i)
+        {
+            wx += traits::weigh(sorted_[i], sorted_weights_[i]);
+            w += traits::weight(sorted_weights_[i]);
+        };
+
+        if (direct)
+        {
+            for (size_t i = first; i < last; ++i)
+                add(i);
+            sum_wx = wx;
+            sum_w = w;
+            return;
+        }
+
+        for (size_t i = 0; i < first; ++i)
+            add(i);
+        for (size_t i = last; i < size_; ++i)
+            add(i);
+        sum_wx = total_wx_ - wx;
+        sum_w = total_w_ - w;
+    }
+
+    // Recompute the running totals exactly from the window contents.
+    void resum() noexcept
+    {
+        total_ = accum_type{};
+        total_wx_ = accum_type{};
+        total_w_ = accum_type{};
+        for (size_t i = 0; i < size_; ++i)
+        {
+            total_ += traits::widen(sorted_[i]);
+            if constexpr (Weighted)
+            {
+                total_wx_ += traits::weigh(sorted_[i], sorted_weights_[i]);
+                total_w_ += traits::weight(sorted_weights_[i]);
+            }
+        }
+        since_resum_ = 0;
+    }
+
+    // Index range [first, last) of sorted samples within [lo, hi].
+    void range(T lo, T hi, size_t &first, size_t &last) const noexcept
+    {
+        first = static_cast<size_t>(std::lower_bound(sorted_begin(), sorted_end(), lo) - sorted_begin());
+        last = static_cast<size_t>(std::upper_bound(sorted_begin(), sorted_end(), hi) - sorted_begin());
+    }
+
+private:
+    void evict_oldest() noexcept
+    {
+        const size_t idx = (head_ + N - size_) % N;
+        const uint16_t old_weight = weight_of_ring(idx);
+        total_ -= traits::widen(ring_[idx]);
+        if constexpr (Weighted)
+        {
+            total_wx_ -= traits::weigh(ring_[idx], old_weight);
+            total_w_ -= traits::weight(old_weight);
+        }
+        erase_sorted(ring_[idx], old_weight);
+    }
+
+    uint16_t weight_of_ring(size_t idx) const noexcept
+    {
+        if constexpr (Weighted)
+            return ring_weights_[idx];
+        else
+            return 1;
+    }
+
+    void insert_sorted(T value, uint16_t weight) noexcept
+    {
+        // size_ already counts the new sample
+        const size_t end = size_ - 1;
+        const size_t pos = static_cast<size_t>(std::upper_bound(sorted_.data(), sorted_.data() + end, value) - sorted_.data());
+        std::move_backward(sorted_.data() + pos, sorted_.data() + end, sorted_.data() + end + 1);
+        sorted_[pos] = value;
+        if constexpr (Weighted)
+        {
+            std::move_backward(sorted_weights_.data() + pos, sorted_weights_.data() + end, sorted_weights_.data() + end + 1);
+            sorted_weights_[pos] = weight;
+        }
+        else
+        {
+            (void)weight;
+        }
+    }
+
+    void erase_sorted(T value, uint16_t weight) noexcept
+    {
+        const size_t end = size_;
+        size_t pos = static_cast<size_t>(std::lower_bound(sorted_.data(), sorted_.data() + end, value) - sorted_.data());
+        if constexpr (Weighted)
+        {
+            // Equal values may carry different weights; remove the matching one
+            while (pos + 1 < end && sorted_weights_[pos] != weight && sorted_[pos + 1] == value)
+                ++pos;
+            std::move(sorted_weights_.data() + pos + 1, sorted_weights_.data() + end, sorted_weights_.data() + pos);
+        }
+        else
+        {
+            (void)weight;
+        }
+        std::move(sorted_.data() + pos + 1, sorted_.data() + end, sorted_.data() + pos);
+        --size_;
+    }
+
+    struct not_stored
+    {
+    };
+    using weight_array = std::conditional_t<Weighted, std::array<uint16_t, N>, not_stored>;
+    using stamp_array = std::conditional_t<Timed, std::array<int64_t, N>, not_stored>;
+
+    std::array<T, N> ring_{};
+    std::array<T, N> sorted_{};
+    [[no_unique_address]] weight_array ring_weights_{};
+    [[no_unique_address]] weight_array sorted_weights_{};
+    [[no_unique_address]] stamp_array ring_stamps_{};
+    size_t head_ = 0;
+    size_t size_ = 0;
+    size_t length_ = N;
+    accum_type total_{};
+    accum_type total_wx_{};
+    accum_type total_w_{};
+    uint32_t since_resum_ = 0;
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "sample_traits.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Re-acquisition logic for a step limiter. Samples the limiter rejects are
+// collected here; once run_length consecutive rejected samples agree with each
+// other (each within max_step of the previous one) the target is taken to have
+// really moved and the run is handed back to re-seed the filter window.
+//
+// Settling is measured as the number of rejected samples between the last
+// accepted sample and the re-seed (run_length for a clean step).
+template <typename T, size_t MaxRun = 16>
+class track_reacquirer
+{
+public:
+    // run_length == 0 disables re-acquisition (the limiter can then lock out
+    // a target that really moved more than max_step between frames).
+    track_reacquirer(size_t run_length, T max_step) noexcept
+        : run_length_(run_length > MaxRun ? MaxRun : run_length), max_step_(max_step) {}
+
+    static constexpr size_t max_run_length = MaxRun;
+
+    // Feed a sample the limiter rejected. Returns true when a consistent run
+    // is complete; run_begin()/run_end() then hold it, oldest first, and
+    // run_weights() and run_stamps() the weight and timestamp each of its
+    // samples was rejected with.
+    bool reject(T value, uint16_t weight = 1, int64_t stamp = 0) noexcept
+    {
+        ++rejected_;
+        if (run_length_ == 0)
+            return false;
+
+        if (run_size_ > 0 && sample_traits<T>::abs(value - run_[run_size_ - 1]) > max_step_)
+            run_size_ = 0;
+        run_weights_[run_size_] = weight;
+        run_stamps_[run_size_] = stamp;
+        run_[run_size_++] = value;
+
+        if (run_size_ < run_length_)
+            return false;
+
+        ++reacquisitions_;
+        last_settling_samples_ = rejected_;
+        rejected_ = 0;
+        completed_ = run_size_;
+        run_size_ = 0;
+        return true;
+    }
+
+    // The limiter accepted a sample: any pending run was a transient.
+    void accept() noexcept
+    {
+        run_size_ = 0;
+        rejected_ = 0;
+    }
+
+    void reset() noexcept
+    {
+        run_size_ = 0;
+        rejected_ = 0;
+        completed_ = 0;
+    }
+
+    // Retune the consistency limit; a pending run is kept
+    void set_max_step(T max_step) noexcept { max_step_ = max_step; }
+
+    // Change the run length (clamped to MaxRun); a pending run starts over
+    void set_run_length(size_t run_length) noexcept
+    {
+        run_length_ = run_length > MaxRun ? MaxRun : run_length;
+        run_size_ = 0;
+    }
+
+    const T *run_begin() const noexcept { return run_.data(); }
+    const T *run_end() const noexcept { return run_.data() + completed_; }
+    const uint16_t *run_weights() const noexcept { return run_weights_.data(); }
+    const int64_t *run_stamps() const noexcept { return run_stamps_.data(); }
+
+    size_t run_length() const noexcept { return run_length_; }
+    uint32_t reacquisitions() const noexcept { return reacquisitions_; }
+    uint32_t last_settling_samples() const noexcept { return last_settling_samples_; }
+
+    // Samples rejected since the last accepted one; 0 when on track
+    uint32_t pending_rejections() const noexcept { return rejected_; }
+
+private:
+    std::array<T, MaxRun> run_{};
+    std::array<uint16_t, MaxRun> run_weights_{};
+    std::array<int64_t, MaxRun> run_stamps_{};
+    size_t run_length_;
+    T max_step_;
+    size_t run_size_ = 0;
+    size_t completed_ = 0;
+    uint32_t rejected_ = 0;
+    uint32_t reacquisitions_ = 0;
+    uint32_t last_settling_samples_ = 0;
+};
@@ -3,7 +3,8 @@
 batch_averager::batch_averager(size_t batch_size,
                                double max_step,
                                double hampel_thresh,
-                               double trim_fraction) noexcept
+                               double trim_fraction,
+                               size_t reacquire_count) noexcept
     : batch_size_(batch_size),
       count_(0),
       curr_avg_m_(0.0),
@@ -11,7 +12,9 @@ batch_averager::batch_averager(size_t batch_size,
       hampel_thresh_(hampel_thresh),
       trim_fraction_(trim_fraction),
       head_(0),
-      full_(false)
+      full_(false),
+      min_fill_(batch_size),
+      reacquirer_(reacquire_count, max_step)
 {
     samples_.resize(batch_size_, 0.0); // Preallocate storage
 }
@@ -27,17 +30,43 @@ void batch_averager::add_sample(double meters) noexcept
         size_t last_idx = (head_ + batch_size_ - 1) % batch_size_;
         double last = samples_[last_idx];
         if (std::fabs(meters - last) > max_step_)
+        {
+            if (!reacquirer_.reject(meters))
+                return;
+
+            // The target really moved: re-seed the window with the consistent
+            // run and publish from the partial window until it refills.
+            head_ = 0;
+            full_ = false;
+            for (const double *it = reacquirer_.run_begin(); it != reacquirer_.run_end(); ++it)
+                push_sample(*it);
+            min_fill_ = std::min(reacquirer_.run_length(), batch_size_);
+            update_average();
             return;
+        }
     }
 
+    reacquirer_.accept();
+    push_sample(meters);
+    update_average();
+    if (full_)
+        min_fill_ = batch_size_;
+}
+
+void batch_averager::push_sample(double meters) noexcept
+{
     // Insert sample in O(1) into circular buffer
     samples_[head_] = meters;
     head_ = (head_ + 1) % batch_size_;
     if (head_ == 0)
         full_ = true;
     ++count_;
+}
 
-    if (is_complete())
+void batch_averager::update_average() noexcept
+{
+    size_t filled = full_ ? batch_size_ : head_;
+    if (filled >= min_fill_)
     {
         // Reconstruct chronological order for filtering
         std::vector<double> data;
@@ -87,6 +116,8 @@ void batch_averager::reset() noexcept
     std::fill(samples_.begin(), samples_.end(), 0.0);
     head_ = 0;
     full_ = false;
+    min_fill_ = batch_size_;
+    reacquirer_.reset();
 }
 
 //----------------------------------------------
@@ -2,9 +2,18 @@
 #include "driver/gpio.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "driver/gpio.h"
+#include <atomic>
+#include <cstdint>
 
+// Status LED. blink() and set() drive the pin directly and blink() sleeps the
+// caller. Once init() has run, the pattern engine drives the pin from an
+// esp_timer instead: callers only post events and never wait. Priority is
+// error code > activity flash > heartbeat; the heartbeat gives way at once.
+// While no pattern is active the engine leaves the pin alone.
 class led
 {
 public:
@@ -13,6 +22,40 @@ public:
     void blink(int times, int delay_ms) noexcept;
     void set(bool on) noexcept;
 
+    // Slow background pulse while nothing else is shown
+    void set_heartbeat(bool enabled) noexcept { heartbeat_.store(enabled, std::memory_order_relaxed); }
+
+    // Short flash; posts while a flash is pending are merged
+    void post_activity() noexcept { activity_.store(true, std::memory_order_relaxed); }
+
+    // Blink code times, then pause. Dropped if error_queue_length codes wait.
+    void post_error(uint8_t code) noexcept;
+
 private:
+    static constexpr uint32_t tick_ms = 10;
+    static constexpr size_t error_queue_length = 4;
+    static constexpr size_t max_steps = 2 * 16;
+
+    struct step_t
+    {
+        bool on;
+        uint16_t ms;
+    };
+
+    static void on_tick(void *arg);
+    void next_pattern() noexcept;
+
     gpio_num_t pin_;
+    esp_timer_handle_t timer_;
+    QueueHandle_t errors_;
+    std::atomic<bool> heartbeat_;
+    std::atomic<bool> activity_;
+
+    // Owned by the timer callback
+    step_t steps_[max_steps];
+    size_t step_count_;
+    size_t step_index_;
+    uint32_t step_left_ms_;
+    bool showing_;     // A pattern is driving the pin
+    bool preemptible_; // Current pattern is the heartbeat
 };
@@ -2,12 +2,43 @@
 
 static constexpr char TAG[] = "LED";
 
-led::led(gpio_num_t led_pin) noexcept : pin_(led_pin) {}
+led::led(gpio_num_t led_pin) noexcept
+    : pin_(led_pin),
+      timer_(nullptr),
+      errors_(nullptr),
+      heartbeat_(false),
+      activity_(false),
+      steps_{},
+      step_count_(0),
+      step_index_(0),
+      step_left_ms_(0),
+      showing_(false),
+      preemptible_(false)
+{
+}
 
 void led::init() noexcept
 {
     gpio_set_direction(pin_, GPIO_MODE_OUTPUT);
     gpio_set_level(pin_, 0);
+
+    errors_ = xQueueCreate(error_queue_length, sizeof(uint8_t));
+    if (errors_ == nullptr)
+        ESP_LOGE(TAG, "Failed to create LED error queue");
+
+    const esp_timer_create_args_t args = {
+        .callback = on_tick,
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "led",
+        .skip_unhandled_events = true,
+    };
+    esp_err_t ret = esp_timer_create(&args, &timer_);
+    if (ret == ESP_OK)
+        ret = esp_timer_start_periodic(timer_, tick_ms * 1000);
+    if (ret != ESP_OK)
+        ESP_LOGE(TAG, "Failed to start LED pattern timer: %s", esp_err_to_name(ret));
+
     ESP_LOGI(TAG, "LED pin %d initialized", pin_);
 }
 
@@ -26,3 +57,75 @@ void led::set(bool on) noexcept
 {
     gpio_set_level(pin_, on ? 1 : 0);
 }
+
+void led::post_error(uint8_t code) noexcept
+{
+    if (errors_ != nullptr && code != 0)
+        xQueueSend(errors_, &code, 0);
+}
+
+void led::on_tick(void *arg)
+{
+    auto *self = static_cast<led *>(arg);
+
+    if (self->preemptible_ &&
+        (self->activity_.load(std::memory_order_relaxed) ||
+         (self->errors_ != nullptr && uxQueueMessagesWaiting(self->errors_) > 0)))
+    {
+        self->step_left_ms_ = 0;
+        self->step_index_ = self->step_count_;
+    }
+
+    if (self->step_left_ms_ > tick_ms)
+    {
+        self->step_left_ms_ -= tick_ms;
+        return;
+    }
+
+    if (++self->step_index_ >= self->step_count_)
+        self->next_pattern();
+
+    if (self->step_count_ == 0)
+    {
+        if (self->showing_)
+            gpio_set_level(self->pin_, 0);
+        self->showing_ = false;
+        self->step_left_ms_ = 0;
+        return;
+    }
+
+    self->showing_ = true;
+    const step_t &step = self->steps_[self->step_index_];
+    gpio_set_level(self->pin_, step.on ? 1 : 0);
+    self->step_left_ms_ = step.ms;
+}
+
+void led::next_pattern() noexcept
+{
+    step_count_ = 0;
+    step_index_ = 0;
+    preemptible_ = false;
+
+    uint8_t code = 0;
+    if (errors_ != nullptr && xQueueReceive(errors_, &code, 0) == pdTRUE)
+    {
+        const size_t blinks = code < max_steps / 2 ? code : max_steps / 2 - 1;
+        for (size_t i = 0; i < blinks; ++i)
+        {
+            steps_[step_count_++] = {true, 200};
+            steps_[step_count_++] = {false, 200};
+        }
+        steps_[step_count_++] = {false, 1000};
+    }
+    else if (activity_.exchange(false, std::memory_order_relaxed))
+    {
+        steps_[step_count_++] = {true, 20};
+        steps_[step_count_++] = {false, 30};
+    }
+    else if (heartbeat_.load(std::memory_order_relaxed))
+    {
+        steps_[step_count_++] = {true, 50};
+        steps_[step_count_++] = {false, 950};
+        preemptible_ = true;
+    }
+}
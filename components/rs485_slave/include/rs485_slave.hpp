@@ -4,6 +4,7 @@
 #include "driver/gpio.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include <string>
 #include <cstring>
 #include <algorithm>
@@ -21,6 +22,11 @@ public:
 
     esp_err_t write(const uint16_t *data, size_t count) noexcept;
 
+    // Wait up to timeout_ms for the master to read the registers. On ESP_OK,
+    // read_us is the esp_timer time of the read. Other register events are
+    // consumed and reported as ESP_ERR_NOT_FOUND.
+    esp_err_t wait_read(int64_t &read_us, uint32_t timeout_ms) noexcept;
+
 private:
     esp_err_t configure_pins() noexcept;
     void free_registers() noexcept;
@@ -181,3 +181,22 @@ esp_err_t rs485::write(const uint16_t *data, size_t count) noexcept
 
     return ESP_OK;
 }
+
+esp_err_t rs485::wait_read(int64_t &read_us, uint32_t timeout_ms) noexcept
+{
+    if (!mbc_slave_handle_)
+        return ESP_ERR_INVALID_STATE;
+
+    mb_param_info_t reg_info{};
+    esp_err_t err = mbc_slave_get_param_info(mbc_slave_handle_, &reg_info, timeout_ms);
+    if (err != ESP_OK)
+        return err;
+
+    if (!(reg_info.type & (MB_EVENT_INPUT_REG_RD | MB_EVENT_HOLDING_REG_RD)))
+        return ESP_ERR_NOT_FOUND;
+
+    // The event carries the low 32 bits of esp_timer time; widen it against now
+    const int64_t now_us = esp_timer_get_time();
+    read_us = now_us - static_cast<uint32_t>(static_cast<uint32_t>(now_us) - reg_info.time_stamp);
+    return ESP_OK;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Latency histogram with power-of-two buckets: bucket i counts values in
+// [2^i, 2^(i+1)) microseconds, bucket 0 also takes 0 and 1 us, and the last
+// bucket takes everything above. Fixed size, O(1) add, no allocation, so it
+// can sit in RAM for every pipeline stage and run for the life of the unit.
+// Quantiles are resolved to the upper edge of the bucket that holds them.
+class latency_histogram
+{
+public:
+    static constexpr size_t bucket_count = 24; // Last bucket starts at ~8.4 s
+
+    void add(uint32_t us) noexcept
+    {
+        ++buckets_[bucket_of(us)];
+        ++count_;
+        sum_us_ += us;
+        if (us > max_us_)
+            max_us_ = us;
+    }
+
+    static constexpr size_t bucket_of(uint32_t us) noexcept
+    {
+        const size_t width = static_cast<size_t>(std::bit_width(us));
+        const size_t b = width > 0 ? width - 1 : 0;
+        return b < bucket_count ? b : bucket_count - 1;
+    }
+
+    // Lower edge of bucket i in microseconds
+    static constexpr uint32_t bucket_floor_us(size_t i) noexcept { return i == 0 ? 0 : uint32_t(1) << i; }
+
+    // Upper bound of the p quantile (0..1); 0 when empty
+    uint32_t quantile_us(float p) const noexcept
+    {
+        if (count_ == 0)
+            return 0;
+
+        const uint32_t rank = static_cast<uint32_t>(p * static_cast<float>(count_ - 1)) + 1;
+        uint32_t seen = 0;
+        for (size_t i = 0; i < bucket_count; ++i)
+        {
+            seen += buckets_[i];
+            if (seen >= rank)
+            {
+                const uint32_t edge = i + 1 < bucket_count ? (uint32_t(1) << (i + 1)) - 1 : max_us_;
+                return edge < max_us_ ? edge : max_us_;
+            }
+        }
+        return max_us_;
+    }
+
+    uint32_t count() const noexcept { return count_; }
+    uint32_t max_us() const noexcept { return max_us_; }
+    uint32_t mean_us() const noexcept { return count_ ? static_cast<uint32_t>(sum_us_ / count_) : 0; }
+    uint32_t bucket(size_t i) const noexcept { return buckets_[i]; }
+
+    void reset() noexcept { *this = latency_histogram{}; }
+
+private:
+    std::array<uint32_t, bucket_count> buckets_{};
+    uint32_t count_ = 0;
+    uint32_t max_us_ = 0;
+    uint64_t sum_us_ = 0;
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <concepts>
+
+// Streaming estimate of one quantile using the P² algorithm (Jain & Chlamtac,
+// 1985). Five markers track the minimum, the p/2, p and (1+p)/2 quantiles and
+// the maximum; each sample moves them with a piecewise-parabolic update, so
+// memory and per-sample cost are constant however long the stream runs.
+template <std::floating_point T = float>
+class p2_quantile
+{
+public:
+    explicit p2_quantile(T p) noexcept : p_(p) { reset(); }
+
+    void add(T x) noexcept
+    {
+        if (count_ < markers)
+        {
+            q_[count_++] = x;
+            if (count_ == markers)
+                std::sort(q_.begin(), q_.end());
+            return;
+        }
+
+        // Cell containing x; extremes stretch to take it in
+        size_t k;
+        if (x < q_[0])
+        {
+            q_[0] = x;
+            k = 0;
+        }
+        else if (x >= q_[4])
+        {
+            q_[4] = x;
+            k = 3;
+        }
+        else
+        {
+            k = 0;
+            while (x >= q_[k + 1])
+                ++k;
+        }
+
+        for (size_t i = k + 1; i < markers; ++i)
+            ++n_[i];
+        for (size_t i = 0; i < markers; ++i)
+            desired_[i] += increment_[i];
+        ++count_;
+
+        // Nudge the middle markers towards their desired positions
+        for (size_t i = 1; i < markers - 1; ++i)
+        {
+            const double d = desired_[i] - static_cast<double>(n_[i]);
+            if ((d >= 1.0 && n_[i + 1] - n_[i] > 1) || (d <= -1.0 && n_[i - 1] - n_[i] < -1))
+            {
+                const int s = d > 0 ? 1 : -1;
+                const T qp = parabolic(i, s);
+                q_[i] = (q_[i - 1] < qp && qp < q_[i + 1]) ? qp : linear(i, s);
+                n_[i] += s;
+            }
+        }
+    }
+
+    // Current estimate; exact while fewer than five samples have been seen
+    T value() const noexcept
+    {
+        if (count_ >= markers)
+            return q_[2];
+        if (count_ == 0)
+            return T{};
+
+        std::array<T, markers> sorted = q_;
+        std::sort(sorted.begin(), sorted.begin() + count_);
+        return sorted[static_cast<size_t>(p_ * static_cast<T>(count_ - 1) + T(0.5))];
+    }
+
+    T quantile() const noexcept { return p_; }
+    uint32_t count() const noexcept { return count_; }
+
+    void reset() noexcept
+    {
+        count_ = 0;
+        q_.fill(T{});
+        n_ = {0, 1, 2, 3, 4};
+        const double p = static_cast<double>(p_);
+        desired_ = {0.0, 2 * p, 4 * p, 2 + 2 * p, 4.0};
+        increment_ = {0.0, p / 2, p, (1 + p) / 2, 1.0};
+    }
+
+private:
+    static constexpr size_t markers = 5;
+
+    // Spacings are taken between the integer positions before converting, so
+    // they stay exact however far the markers have advanced
+    T parabolic(size_t i, int s) const noexcept
+    {
+        const double ds = s;
+        const double left = static_cast<double>(n_[i] - n_[i - 1]);
+        const double right = static_cast<double>(n_[i + 1] - n_[i]);
+        const double q_prev = q_[i - 1], q_i = q_[i], q_next = q_[i + 1];
+        return static_cast<T>(q_i + ds / (left + right) *
+                                        ((left + ds) * (q_next - q_i) / right +
+                                         (right - ds) * (q_i - q_prev) / left));
+    }
+
+    T linear(size_t i, int s) const noexcept
+    {
+        const size_t j = s > 0 ? i + 1 : i - 1;
+        return q_[i] + static_cast<T>(s) * (q_[j] - q_[i]) / static_cast<T>(n_[j] - n_[i]);
+    }
+
+    T p_;
+    uint32_t count_;
+    std::array<T, markers> q_;
+    // Marker positions are counts that grow with every sample. They are kept
+    // in 64-bit integers and doubles whatever T is: a float stops registering
+    // the fractional increments after about 2^24 samples (days at frame
+    // rate) and the markers would stop tracking.
+    std::array<int64_t, markers> n_;
+    std::array<double, markers> desired_;
+    std::array<double, markers> increment_;
+};
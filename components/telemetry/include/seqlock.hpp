@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer, multi-reader publication of a small value. The writer never
+// waits; readers copy the value and retry if a write overlapped the copy
+// (odd or changed sequence). The payload is stored as relaxed atomic words so
+// a torn copy is detected rather than being a data race.
+template <typename T>
+class seqlock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "seqlock payload must be trivially copyable");
+
+public:
+    // Publish a new value (one writer task only)
+    void write(const T &value) noexcept
+    {
+        std::array<uint32_t, words> src{};
+        std::memcpy(src.data(), &value, sizeof(T));
+
+        const uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < words; ++i)
+            data_[i].store(src[i], std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Copy the latest value. Returns false if nothing was published yet or
+    // every attempt overlapped a write (e.g. the writer was preempted
+    // mid-update by this reader); out is then left untouched.
+    bool read(T &out, uint32_t attempts = 8) const noexcept
+    {
+        std::array<uint32_t, words> dst{};
+        while (attempts-- > 0)
+        {
+            const uint32_t before = seq_.load(std::memory_order_acquire);
+            if (before & 1u)
+                continue;
+
+            for (size_t i = 0; i < words; ++i)
+                dst[i] = data_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (seq_.load(std::memory_order_relaxed) == before)
+            {
+                if (before == 0)
+                    return false;
+                std::memcpy(&out, dst.data(), sizeof(T));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Number of values published so far
+    uint32_t version() const noexcept { return seq_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t words = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t> seq_{0};
+    std::array<std::atomic<uint32_t>, words> data_{};
+};
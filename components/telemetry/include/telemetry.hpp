@@ -0,0 +1,249 @@
+#pragma once
+
+#include "p2_quantile.hpp"
+#include "latency_histogram.hpp"
+#include "seqlock.hpp"
+#include "freertos/FreeRTOS.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Measurement statistics shared between the task that processes the frames,
+// which records every one of them, and readers such as the web server. Percentiles are streamed
+// with P² estimators, so memory stays constant however long the unit runs.
+// The latest frame is published through a seqlock, so any number of readers
+// can poll it without ever blocking the processing task. Every frame also
+// leaves a trace of when it passed each pipeline stage; the stage latencies go
+// into per-stage histograms and the newest traces are kept in a ring.
+class telemetry
+{
+public:
+    // Latest frame as seen by the processing task
+    struct measurement_t
+    {
+        int64_t timestamp_us; // esp_timer time the frame was received
+        float distance_m;     // Raw distance
+        float average_m;      // Averaged distance
+        uint16_t magnitude;   // Signal magnitude (0.01 dB)
+        uint16_t error;       // vld1 error code, 0 when the frame is valid
+    };
+
+    // Hand-over between the acquisition task and its consumer
+    struct pipeline_stats_t
+    {
+        uint32_t queued;             // Frames handed to the consumer
+        uint32_t dropped;            // Frames lost because the queue stayed full
+        uint32_t backpressure_waits; // Times acquisition waited for queue space
+        uint32_t queue_high_water;   // Deepest queue occupancy seen
+    };
+
+    // Pacing of the acquisition task
+    struct schedule_stats_t
+    {
+        uint32_t rate_hz;       // Configured rate, 0 when free-running
+        uint32_t cycles;        // Acquisition cycles since start
+        uint32_t overruns;      // Periods missed because a cycle ran long
+        float achieved_hz;      // Measured cycle rate
+        float jitter_rms_us;    // RMS deviation of the period from nominal
+        uint32_t jitter_max_us; // Largest deviation of the period from nominal
+    };
+
+    // Sensor link health as seen by the acquisition task
+    struct health_stats_t
+    {
+        bool sensor_ok;                // Last request succeeded
+        uint32_t consecutive_failures; // Failed requests in the current outage
+        uint32_t failures;             // Failed requests since start
+        uint32_t outages;              // Outages recovered from since start
+        uint32_t backoff_ms;           // Current delay before the next request
+        uint32_t last_outage_ms;       // First failure to first success, last outage
+        uint32_t last_recovery_ms;     // Last failed probe to first success, last outage
+        uint32_t max_recovery_ms;      // Largest recovery time seen
+    };
+
+    // Averager re-acquisitions after the target moved further than max_step
+    struct reacquisition_stats_t
+    {
+        uint32_t reacquisitions;        // Re-seeds since start
+        uint32_t last_settling_samples; // Rejected samples before the last re-seed
+        uint32_t last_settling_ms;      // Last accepted sample to re-seed, last time
+        uint32_t max_settling_ms;       // Longest settling time seen
+    };
+
+    // Sensor UART reception, first byte of a frame to its last
+    struct serial_stats_t
+    {
+        uint32_t frames;  // Frames read since the RX tuning was last set
+        uint32_t last_us; // Latest frame
+        uint32_t mean_us; // Mean over all frames
+        uint32_t max_us;  // Slowest frame
+    };
+
+    // Runtime tuning of the distance averager
+    struct averager_settings_t
+    {
+        uint16_t window;     // Active window length in samples
+        uint16_t capacity;   // Largest window the averager supports (read only)
+        float max_step_m;    // Step limiter threshold
+        float hampel_thresh; // Hampel threshold in MAD units
+        float trim_fraction; // Fraction trimmed from each end
+        uint16_t reacquire_count; // Out-of-step samples that re-seed the window (settling)
+        uint16_t reacquire_max;   // Largest re-acquisition count supported (read only)
+    };
+
+    // Pipeline stages timed for every frame, each from the end of the one before
+    enum class latency_stage_t : uint8_t
+    {
+        sensor_response, // GNFD sent -> RESP received
+        decode,          // RESP received -> PDAT decoded
+        averaging,       // PDAT decoded -> averaged (includes the frame queue)
+        register_update, // Averaged -> Modbus registers updated
+        master_read,     // Registers updated -> first read by the Modbus master
+        end_to_end,      // GNFD sent -> first read by the Modbus master
+    };
+    static constexpr size_t latency_stage_count = 6;
+
+    static const char *latency_stage_name(latency_stage_t stage) noexcept;
+
+    // esp_timer timestamps of one frame; 0 where a stage was not reached
+    struct frame_trace_t
+    {
+        uint32_t sequence;
+        int64_t gnfd_sent_us;
+        int64_t resp_received_us;
+        int64_t pdat_decoded_us;
+        int64_t averaged_us;
+        int64_t registers_us;
+        int64_t first_read_us;
+    };
+
+    static constexpr size_t trace_length = 32;
+
+    struct quantiles_t
+    {
+        float p50;
+        float p95;
+        float p99;
+    };
+
+    struct jitter_stats_t
+    {
+        uint32_t frames;         // Frames with a valid distance since the last reset
+        quantiles_t deviation_mm; // |raw - averaged| distance
+        quantiles_t interval_ms;  // Time between consecutive valid frames
+    };
+
+    telemetry() noexcept;
+
+    // Record one valid frame (processing task). deviation_m is the distance
+    // of the raw sample from the averaged output; pass a negative value while
+    // the averager has no output yet.
+    void record_frame(float deviation_m, int64_t timestamp_us) noexcept;
+
+    // Consistent copy of the current percentiles (any task)
+    jitter_stats_t jitter() const noexcept;
+
+    void reset_jitter() noexcept;
+
+    // Publish the latest frame (processing task, once per frame). Never blocks.
+    void publish(const measurement_t &m) noexcept { latest_.write(m); }
+
+    // Copy the latest published frame without blocking the publisher.
+    // Returns false if nothing has been published yet.
+    bool latest(measurement_t &m) const noexcept { return latest_.read(m); }
+
+    // Record the stage timestamps of a frame once its registers are updated
+    // (processing task). Stage latencies go into the histograms and the
+    // trace into the ring; sequence is assigned here.
+    void record_trace(frame_trace_t trace) noexcept;
+
+    // The Modbus master read the registers at read_us (any task). Completes
+    // the trace of the last frame written before read_us, if this is the
+    // first read of it; frames recorded after read_us are skipped.
+    void note_master_read(int64_t read_us) noexcept;
+
+    // Consistent copy of one stage histogram (any task)
+    latency_histogram latency(latency_stage_t stage) const noexcept;
+
+    // Copy up to max traces, newest first; returns how many were copied
+    size_t traces(frame_trace_t *out, size_t max) const noexcept;
+
+    void reset_latency() noexcept;
+
+    // Pipeline counters (acquisition task updates, any task reads)
+    void note_frame_queued(size_t depth) noexcept;
+    void note_frame_dropped() noexcept { dropped_.fetch_add(1, std::memory_order_relaxed); }
+    void note_backpressure_wait() noexcept { backpressure_waits_.fetch_add(1, std::memory_order_relaxed); }
+    pipeline_stats_t pipeline() const noexcept;
+
+    // Samples the averager dropped below its magnitude floor (processing
+    // task stores the running total, any task reads)
+    void note_weak_samples(uint32_t total) noexcept { weak_samples_.store(total, std::memory_order_relaxed); }
+    uint32_t weak_samples() const noexcept { return weak_samples_.load(std::memory_order_relaxed); }
+
+    // Scheduler metrics (acquisition task publishes, any task reads)
+    void publish_schedule(const schedule_stats_t &s) noexcept { schedule_.write(s); }
+    bool schedule(schedule_stats_t &s) const noexcept { return schedule_.read(s); }
+
+    // Sensor health (acquisition task publishes, any task reads)
+    void publish_health(const health_stats_t &h) noexcept { health_.write(h); }
+    bool health(health_stats_t &h) const noexcept { return health_.read(h); }
+
+    // Averager re-acquisitions (processing task publishes, any task reads)
+    void publish_reacquisition(const reacquisition_stats_t &r) noexcept { reacquisition_.write(r); }
+    bool reacquisition(reacquisition_stats_t &r) const noexcept { return reacquisition_.read(r); }
+
+    // Sensor UART timing (acquisition task publishes, any task reads)
+    void publish_serial(const serial_stats_t &s) noexcept { serial_.write(s); }
+    bool serial(serial_stats_t &s) const noexcept { return serial_.read(s); }
+
+    // Ask the processing task to apply new averager settings (one writer
+    // task, e.g. the web server). Never blocks.
+    void request_averager_settings(const averager_settings_t &s) noexcept { settings_request_.write(s); }
+
+    // Fetch settings requested since the last call (processing task only)
+    bool take_averager_settings(averager_settings_t &s) noexcept;
+
+    // Settings currently in effect, published by the processing task
+    void publish_averager_settings(const averager_settings_t &s) noexcept { settings_applied_.write(s); }
+    bool averager_settings(averager_settings_t &s) const noexcept { return settings_applied_.read(s); }
+
+private:
+    struct quantile_set
+    {
+        p2_quantile<float> p50{0.50f};
+        p2_quantile<float> p95{0.95f};
+        p2_quantile<float> p99{0.99f};
+
+        void add(float x) noexcept;
+        quantiles_t values() const noexcept;
+        void reset() noexcept;
+    };
+
+    void add_latency(latency_stage_t stage, int64_t from_us, int64_t to_us) noexcept;
+
+    mutable portMUX_TYPE lock_;
+    uint32_t frames_;
+    int64_t last_frame_us_;
+    quantile_set deviation_mm_;
+    quantile_set interval_ms_;
+    std::array<latency_histogram, latency_stage_count> latency_;
+    std::array<frame_trace_t, trace_length> traces_;
+    size_t trace_head_;
+    size_t trace_count_;
+    uint32_t trace_sequence_;
+    seqlock<measurement_t> latest_;
+    seqlock<schedule_stats_t> schedule_;
+    seqlock<health_stats_t> health_;
+    seqlock<reacquisition_stats_t> reacquisition_;
+    seqlock<serial_stats_t> serial_;
+    std::atomic<uint32_t> queued_{0};
+    std::atomic<uint32_t> dropped_{0};
+    std::atomic<uint32_t> backpressure_waits_{0};
+    std::atomic<uint32_t> queue_high_water_{0};
+    std::atomic<uint32_t> weak_samples_{0};
+    seqlock<averager_settings_t> settings_request_;
+    seqlock<averager_settings_t> settings_applied_;
+    uint32_t settings_taken_;
+};
@@ -0,0 +1,193 @@
+#include "telemetry.hpp"
+
+telemetry::telemetry() noexcept
+    : lock_(portMUX_INITIALIZER_UNLOCKED),
+      frames_(0),
+      last_frame_us_(-1),
+      latency_{},
+      traces_{},
+      trace_head_(0),
+      trace_count_(0),
+      trace_sequence_(0),
+      settings_taken_(0)
+{
+}
+
+void telemetry::quantile_set::add(float x) noexcept
+{
+    p50.add(x);
+    p95.add(x);
+    p99.add(x);
+}
+
+telemetry::quantiles_t telemetry::quantile_set::values() const noexcept
+{
+    return {p50.value(), p95.value(), p99.value()};
+}
+
+void telemetry::quantile_set::reset() noexcept
+{
+    p50.reset();
+    p95.reset();
+    p99.reset();
+}
+
+void telemetry::record_frame(float deviation_m, int64_t timestamp_us) noexcept
+{
+    portENTER_CRITICAL(&lock_);
+
+    ++frames_;
+    if (deviation_m >= 0.0f)
+        deviation_mm_.add(deviation_m * 1000.0f);
+    if (last_frame_us_ >= 0)
+        interval_ms_.add(static_cast<float>(timestamp_us - last_frame_us_) / 1000.0f);
+    last_frame_us_ = timestamp_us;
+
+    portEXIT_CRITICAL(&lock_);
+}
+
+telemetry::jitter_stats_t telemetry::jitter() const noexcept
+{
+    portENTER_CRITICAL(&lock_);
+    jitter_stats_t stats{frames_, deviation_mm_.values(), interval_ms_.values()};
+    portEXIT_CRITICAL(&lock_);
+    return stats;
+}
+
+void telemetry::reset_jitter() noexcept
+{
+    portENTER_CRITICAL(&lock_);
+    frames_ = 0;
+    last_frame_us_ = -1;
+    deviation_mm_.reset();
+    interval_ms_.reset();
+    portEXIT_CRITICAL(&lock_);
+}
+
+const char *telemetry::latency_stage_name(latency_stage_t stage) noexcept
+{
+    switch (stage)
+    {
+    case latency_stage_t::sensor_response:
+        return "sensor_response";
+    case latency_stage_t::decode:
+        return "decode";
+    case latency_stage_t::averaging:
+        return "averaging";
+    case latency_stage_t::register_update:
+        return "register_update";
+    case latency_stage_t::master_read:
+        return "master_read";
+    case latency_stage_t::end_to_end:
+        return "end_to_end";
+    }
+    return "unknown";
+}
+
+// Caller holds lock_
+void telemetry::add_latency(latency_stage_t stage, int64_t from_us, int64_t to_us) noexcept
+{
+    if (from_us <= 0 || to_us < from_us)
+        return;
+
+    const int64_t us = to_us - from_us;
+    latency_[static_cast<size_t>(stage)].add(us > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(us));
+}
+
+void telemetry::record_trace(frame_trace_t trace) noexcept
+{
+    trace.first_read_us = 0;
+
+    portENTER_CRITICAL(&lock_);
+
+    trace.sequence = trace_sequence_++;
+    add_latency(latency_stage_t::sensor_response, trace.gnfd_sent_us, trace.resp_received_us);
+    add_latency(latency_stage_t::decode, trace.resp_received_us, trace.pdat_decoded_us);
+    add_latency(latency_stage_t::averaging, trace.pdat_decoded_us, trace.averaged_us);
+    add_latency(latency_stage_t::register_update, trace.averaged_us, trace.registers_us);
+
+    traces_[trace_head_] = trace;
+    trace_head_ = (trace_head_ + 1) % trace_length;
+    if (trace_count_ < trace_length)
+        ++trace_count_;
+
+    portEXIT_CRITICAL(&lock_);
+}
+
+void telemetry::note_master_read(int64_t read_us) noexcept
+{
+    portENTER_CRITICAL(&lock_);
+
+    // The read returned the registers of the last frame written before it.
+    // The read event is reported late, so newer frames may already be
+    // recorded; step back past them. Older frames were overwritten unread.
+    for (size_t i = 0; i < trace_count_; ++i)
+    {
+        frame_trace_t &trace = traces_[(trace_head_ + trace_length - 1 - i) % trace_length];
+        if (trace.registers_us == 0 || trace.registers_us > read_us)
+            continue;
+
+        if (trace.first_read_us == 0)
+        {
+            trace.first_read_us = read_us;
+            add_latency(latency_stage_t::master_read, trace.registers_us, read_us);
+            add_latency(latency_stage_t::end_to_end, trace.gnfd_sent_us, read_us);
+        }
+        break;
+    }
+
+    portEXIT_CRITICAL(&lock_);
+}
+
+latency_histogram telemetry::latency(latency_stage_t stage) const noexcept
+{
+    portENTER_CRITICAL(&lock_);
+    latency_histogram copy = latency_[static_cast<size_t>(stage)];
+    portEXIT_CRITICAL(&lock_);
+    return copy;
+}
+
+size_t telemetry::traces(frame_trace_t *out, size_t max) const noexcept
+{
+    portENTER_CRITICAL(&lock_);
+    const size_t n = max < trace_count_ ? max : trace_count_;
+    for (size_t i = 0; i < n; ++i)
+        out[i] = traces_[(trace_head_ + trace_length - 1 - i) % trace_length];
+    portEXIT_CRITICAL(&lock_);
+    return n;
+}
+
+void telemetry::reset_latency() noexcept
+{
+    portENTER_CRITICAL(&lock_);
+    for (latency_histogram &h : latency_)
+        h.reset();
+    trace_head_ = 0;
+    trace_count_ = 0;
+    portEXIT_CRITICAL(&lock_);
+}
+
+bool telemetry::take_averager_settings(averager_settings_t &s) noexcept
+{
+    const uint32_t version = settings_request_.version();
+    if (version == settings_taken_ || !settings_request_.read(s))
+        return false;
+
+    settings_taken_ = version;
+    return true;
+}
+
+void telemetry::note_frame_queued(size_t depth) noexcept
+{
+    queued_.fetch_add(1, std::memory_order_relaxed);
+    if (depth > queue_high_water_.load(std::memory_order_relaxed))
+        queue_high_water_.store(static_cast<uint32_t>(depth), std::memory_order_relaxed);
+}
+
+telemetry::pipeline_stats_t telemetry::pipeline() const noexcept
+{
+    return {queued_.load(std::memory_order_relaxed),
+            dropped_.load(std::memory_order_relaxed),
+            backpressure_waits_.load(std::memory_order_relaxed),
+            queue_high_water_.load(std::memory_order_relaxed)};
+}
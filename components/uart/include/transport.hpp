@@ -0,0 +1,19 @@
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+// Compile-time interface the protocol drivers are instantiated over.
+// Anything that moves bytes (IDF uart, pty, loopback, recording tap) can be
+// plugged in without virtual dispatch. Timeouts are in RTOS ticks and status
+// codes follow esp_err_t (0 == ESP_OK).
+template <typename T>
+concept byte_transport = requires(T &t, uint8_t *dst, const uint8_t *src, size_t len, uint32_t ticks, int baud) {
+    { t.read(dst, len, ticks) } -> std::convertible_to<int>;
+    { t.read_exact(dst, len) } -> std::convertible_to<int>;
+    { t.read_exact(dst, len, ticks) } -> std::convertible_to<int>;
+    { t.write(src, len) } -> std::convertible_to<int>;
+    { t.flush_buffer() };
+    { t.baud_rate() } -> std::convertible_to<int>;
+    { t.set_baud_rate(baud) } -> std::convertible_to<int>;
+};
@@ -3,6 +3,8 @@
 #include "driver/uart.h"
 #include "esp_log.h"
 #include "esp_err.h"
+#include "esp_timer.h"
+#include "transport.hpp"
 #include <cstring>
 
 #include <cstddef>
@@ -11,12 +13,49 @@
 class uart
 {
 public:
+    // RX interrupt tuning: the driver hands bytes to readers when the RX FIFO
+    // reaches full_threshold or the line has been idle for timeout_symbols.
+    struct rx_tuning_t
+    {
+        uint8_t full_threshold;
+        uint8_t timeout_symbols;
+    };
+
+    // IDF driver defaults; fewer interrupts, frames wait for the idle timeout.
+    static constexpr rx_tuning_t rx_tuning_default{120, 10};
+
+    // Interrupt once a frame of frame_size bytes is in the FIFO and flush tails after 2 idle symbols.
+    static constexpr rx_tuning_t rx_tuning_low_latency(size_t frame_size) noexcept
+    {
+        return rx_tuning_t{static_cast<uint8_t>(frame_size < 1 ? 1 : frame_size > 120 ? 120 : frame_size), 2};
+    }
+
+    // read_exact() frames, timed from the driver delivering the first byte to
+    // the last. The wait for the peer to answer is excluded; a frame split
+    // over several RX interrupts shows up as a longer time.
+    struct rx_stats_t
+    {
+        uint32_t frames;
+        int64_t last_us;
+        int64_t max_us;
+        int64_t total_us;
+    };
+
     uart(uart_port_t port, int tx_pin, int rx_pin, int baud_rate = 115200, size_t rx_buf_size = 512) noexcept;
     ~uart() noexcept;
 
     esp_err_t init(uart_word_length_t data_bits = UART_DATA_8_BITS,
                    uart_parity_t parity = UART_PARITY_DISABLE,
-                   uart_stop_bits_t stop_bits = UART_STOP_BITS_1) noexcept;
+                   uart_stop_bits_t stop_bits = UART_STOP_BITS_1,
+                   rx_tuning_t rx_tuning = rx_tuning_default) noexcept;
+
+    esp_err_t set_rx_tuning(rx_tuning_t rx_tuning) noexcept;
+
+    // Switch baud rate and framing on the running driver: drains TX, applies the
+    // new settings (the ones already switched are rolled back if a later one
+    // fails) and discards RX bytes received at the old rate.
+    esp_err_t reconfigure(int baud_rate, uart_parity_t parity, uart_stop_bits_t stop_bits) noexcept;
+    esp_err_t set_baud_rate(int baud_rate) noexcept;
 
     int read(uint8_t *dst, size_t max_len, TickType_t ticks_to_wait) noexcept;
     esp_err_t read_exact(uint8_t *dst, size_t max_len, TickType_t ticks_to_wait = 10) noexcept;
@@ -33,6 +72,10 @@ public:
     int tx_pin() const noexcept { return config_.tx_pin; }
     int rx_pin() const noexcept { return config_.rx_pin; }
     size_t rx_buf_size() const noexcept { return config_.rx_buf_size; }
+    rx_tuning_t rx_tuning() const noexcept { return config_.rx_tuning; }
+
+    const rx_stats_t &rx_stats() const noexcept { return rx_stats_; }
+    void reset_rx_stats() noexcept { rx_stats_ = {}; }
 
     uart_port_t port() const noexcept { return port_; }
 
@@ -48,5 +91,9 @@ private:
         int tx_pin;
         int rx_pin;
         size_t rx_buf_size;
+        rx_tuning_t rx_tuning;
     } config_;
+    rx_stats_t rx_stats_{};
 };
+
+static_assert(byte_transport<uart>, "uart must model byte_transport");
@@ -13,6 +13,7 @@ uart::uart(uart_port_t port, int tx_pin, int rx_pin, int baud_rate, size_t rx_bu
     config_.parity = UART_PARITY_DISABLE;
     config_.stop_bits = UART_STOP_BITS_1;
     config_.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    config_.rx_tuning = rx_tuning_default;
 }
 
 uart::~uart() noexcept
@@ -20,7 +21,8 @@ uart::~uart() noexcept
     uart_driver_delete(port_);
 }
 
-esp_err_t uart::init(uart_word_length_t data_bits, uart_parity_t parity, uart_stop_bits_t stop_bits) noexcept
+esp_err_t uart::init(uart_word_length_t data_bits, uart_parity_t parity, uart_stop_bits_t stop_bits,
+                     rx_tuning_t rx_tuning) noexcept
 {
 
     config_.data_bits = data_bits;
@@ -56,10 +58,99 @@ esp_err_t uart::init(uart_word_length_t data_bits, uart_parity_t parity, uart_st
         return err;
     }
 
+    err = set_rx_tuning(rx_tuning);
+    if (err != ESP_OK)
+        return err;
+
     ESP_LOGI(TAG, "UART%u initialized (TX=%d RX=%d @%d)", port_, config_.tx_pin, config_.rx_pin, config_.baud_rate);
     return ESP_OK;
 }
 
+esp_err_t uart::set_rx_tuning(rx_tuning_t rx_tuning) noexcept
+{
+    esp_err_t err = uart_set_rx_full_threshold(port_, rx_tuning.full_threshold);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "uart_set_rx_full_threshold failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    err = uart_set_rx_timeout(port_, rx_tuning.timeout_symbols);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "uart_set_rx_timeout failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    config_.rx_tuning = rx_tuning;
+    reset_rx_stats();
+
+    ESP_LOGI(TAG, "UART%u RX tuning: threshold=%u bytes, timeout=%u symbols",
+             port_, rx_tuning.full_threshold, rx_tuning.timeout_symbols);
+    return ESP_OK;
+}
+
+esp_err_t uart::reconfigure(int baud_rate, uart_parity_t parity, uart_stop_bits_t stop_bits) noexcept
+{
+    if (baud_rate <= 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = uart_wait_tx_done(port_, pdMS_TO_TICKS(100));
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "uart_wait_tx_done failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    // Each driver call switches one field. If one is refused, exactly the
+    // fields already switched are put back, so the port never keeps a new
+    // baud rate with the old framing. uart_param_config() would take them
+    // in one call, but it re-initialises the port and drops a mode set with
+    // uart_set_mode() (RS485 half duplex).
+    int applied = 0;
+    err = uart_set_baudrate(port_, static_cast<uint32_t>(baud_rate));
+    if (err == ESP_OK)
+    {
+        ++applied;
+        err = uart_set_parity(port_, parity);
+    }
+    if (err == ESP_OK)
+    {
+        ++applied;
+        err = uart_set_stop_bits(port_, stop_bits);
+    }
+
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "UART%u reconfigure failed: %s", port_, esp_err_to_name(err));
+
+        esp_err_t restore_err = ESP_OK;
+        if (applied >= 2 && uart_set_parity(port_, config_.parity) != ESP_OK)
+            restore_err = ESP_FAIL;
+        if (applied >= 1 && uart_set_baudrate(port_, static_cast<uint32_t>(config_.baud_rate)) != ESP_OK)
+            restore_err = ESP_FAIL;
+        if (restore_err != ESP_OK)
+            ESP_LOGE(TAG, "UART%u could not restore its previous settings (@%d)", port_, config_.baud_rate);
+        return err;
+    }
+
+    uart_flush_input(port_);
+
+    config_.baud_rate = baud_rate;
+    config_.parity = parity;
+    config_.stop_bits = stop_bits;
+
+    ESP_LOGI(TAG, "UART%u reconfigured (@%d)", port_, config_.baud_rate);
+    return ESP_OK;
+}
+
+esp_err_t uart::set_baud_rate(int baud_rate) noexcept
+{
+    return reconfigure(baud_rate, config_.parity, config_.stop_bits);
+}
+
 int uart::read(uint8_t *dst, size_t max_len, TickType_t ticks_to_wait) noexcept
 {
     return uart_read_bytes(port_, dst, max_len, ticks_to_wait);
@@ -72,15 +163,20 @@ esp_err_t uart::read_exact(uint8_t *dst, size_t max_len, TickType_t ticks_to_wai
         return ESP_ERR_INVALID_ARG;
     }
     size_t total_read = 0;
+    int64_t first_byte_us = 0;
     const TickType_t start_tick = xTaskGetTickCount();
 
-    int n = read(dst, max_len, ticks_to_wait);
+    // Wait for the first byte on its own so the transfer time below starts
+    // when data arrives, not when the caller started waiting for a reply
+    int n = read(dst, 1, ticks_to_wait);
 
     if (n < 0)
     {
         ESP_LOGE(TAG, "UART read error on first attempt.");
         return ESP_FAIL;
     }
+    if (n > 0)
+        first_byte_us = esp_timer_get_time();
     total_read += static_cast<size_t>(n);
 
     while (total_read < max_len)
@@ -106,8 +202,18 @@ esp_err_t uart::read_exact(uint8_t *dst, size_t max_len, TickType_t ticks_to_wai
             continue;
         }
 
+        if (first_byte_us == 0)
+            first_byte_us = esp_timer_get_time();
         total_read += static_cast<size_t>(n);
     }
+
+    const int64_t elapsed_us = esp_timer_get_time() - first_byte_us;
+    ++rx_stats_.frames;
+    rx_stats_.last_us = elapsed_us;
+    rx_stats_.total_us += elapsed_us;
+    if (elapsed_us > rx_stats_.max_us)
+        rx_stats_.max_us = elapsed_us;
+
     return ESP_OK;
 }
 
@@ -0,0 +1,248 @@
+#pragma once
+#include "transport.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Wire-level types of the VLD1 protocol, shared by every transport
+// instantiation, with the frame encoding and decoding and the PDAT exchange.
+// Nothing here depends on ESP-IDF, so it compiles and runs on a host against
+// any byte_transport.
+struct vld1_protocol
+{
+    enum class vld1_error_code_t : uint8_t
+    {
+        OK = 0,
+        UNKNOWN_CMD = 1,
+        INVALID_PARAM_VAL = 2,
+        INVALID_RPST_VERS = 3,
+        UART_ERROR = 4,
+        NO_CALIB_VALUES = 5,
+        TIMEOUT = 6,
+        APP_CORRUPT = 7,
+        INVALID_DATA_RECEIVED = 8,
+        RESP_FRAME_ERR = 9,
+        MUTEX_ERR = 10,
+        SAVE_FAIL = 11,
+    };
+
+    enum class vld1_baud_t : uint8_t
+    {
+        BAUD_115200 = 0,
+        BAUD_460800 = 1,
+        BAUD_921600 = 2,
+        BAUD_2000000 = 3,
+    };
+
+    enum class vld1_distance_range_t : uint8_t
+    {
+        range_20 = 0,
+        range_50 = 1
+    };
+
+    enum class target_filter_t : uint8_t
+    {
+        strongest = 0,
+        nearest = 1,
+        farthest = 2
+    };
+
+    enum class precision_mode_t : uint8_t
+    {
+        low = 0,
+        high = 1
+    };
+
+    enum class short_range_distance_t : uint8_t
+    {
+        disable = 0,
+        enable = 1
+    };
+
+    enum class gnfd_payload_t : uint8_t
+    {
+        DONE = 1U << 5,
+        PDAT = 1U << 2,
+        RFFT = 1U << 1,
+        RADC = 1U << 0
+    };
+
+#pragma pack(push, 1)
+    typedef struct
+    {
+        char firmware_version[19];
+        char unique_id[12];
+        vld1_distance_range_t distance_range;
+        uint8_t threshold_offset;
+        uint16_t min_range_filter;
+        uint16_t max_range_filter;
+        uint8_t distance_avg_count;
+        target_filter_t target_filter;
+        precision_mode_t distance_precision;
+        uint8_t tx_power;
+        uint8_t chirp_integration_count;
+        short_range_distance_t short_range_distance_filter;
+    } radar_params_t;
+#pragma pack(pop)
+
+#pragma pack(push, 1)
+    typedef struct
+    {
+        char header[4];
+        uint32_t payload_len;
+    } vld1_header_t;
+#pragma pack(pop)
+
+#pragma pack(push, 1)
+    typedef struct
+    {
+        vld1_header_t header;
+        vld1_error_code_t err_code;
+    } resp_t;
+#pragma pack(pop)
+
+#pragma pack(push, 1)
+    typedef struct
+    {
+        vld1_header_t header;
+        char version[19];
+    } vers_resp_t;
+#pragma pack(pop)
+
+#pragma pack(push, 1)
+    typedef struct
+    {
+        vld1_header_t header;
+        radar_params_t params;
+    } rpst_resp_t;
+#pragma pack(pop)
+
+#pragma pack(push, 1)
+    typedef struct
+    {
+        float distance;
+        uint16_t magnitude;
+    } pdat_payload_t;
+#pragma pack(pop)
+
+#pragma pack(push, 1)
+    typedef struct
+    {
+        vld1_header_t header;
+        pdat_payload_t payload;
+    } pdat_resp_t;
+#pragma pack(pop)
+
+#pragma pack(push, 1)
+    typedef struct
+    {
+        vld1_header_t header;
+    } grps_req_t;
+#pragma pack(pop)
+
+#pragma pack(push, 1)
+    typedef struct
+    {
+        vld1_header_t header;
+        radar_params_t params;
+    } srps_req_t;
+#pragma pack(pop)
+
+#pragma pack(push, 1)
+    typedef struct
+    {
+        vld1_header_t header;
+        gnfd_payload_t payload;
+    } gnfd_req_t;
+#pragma pack(pop)
+
+    // Timestamps of one PDAT exchange (esp_timer on target); 0 where it stopped short
+    struct pdat_timing_t
+    {
+        int64_t gnfd_sent_us;     // GNFD request written to the transport
+        int64_t resp_received_us; // RESP status frame received
+        int64_t pdat_decoded_us;  // PDAT frame read and validated
+    };
+
+    // Largest frame encode_frame() produces
+    static constexpr size_t max_frame_len = 512;
+
+    // Serialise header and payload into buf. Returns the frame length, or 0 if
+    // it does not fit in cap bytes.
+    static size_t encode_frame(const vld1_header_t &header, const uint8_t *payload,
+                               uint8_t *buf, size_t cap) noexcept
+    {
+        const size_t total_len = sizeof(vld1_header_t) + header.payload_len;
+        if (header.payload_len > cap || total_len > cap)
+            return 0;
+
+        std::memcpy(buf, &header, sizeof(vld1_header_t));
+        if (header.payload_len && payload)
+            std::memcpy(buf + sizeof(vld1_header_t), payload, header.payload_len);
+        return total_len;
+    }
+
+    static bool has_header(const vld1_header_t &header, const char (&code)[5]) noexcept
+    {
+        return std::strncmp(header.header, code, 4) == 0;
+    }
+
+    // Status reported by a RESP frame, RESP_FRAME_ERR if it is not a valid one
+    static vld1_error_code_t decode_resp(const resp_t &resp) noexcept
+    {
+        if (!has_header(resp.header, "RESP") || resp.header.payload_len != sizeof(vld1_error_code_t))
+            return vld1_error_code_t::RESP_FRAME_ERR;
+        return resp.err_code;
+    }
+
+    // Payload of a PDAT frame, INVALID_DATA_RECEIVED if it is not a valid one
+    static vld1_error_code_t decode_pdat(const pdat_resp_t &resp, pdat_payload_t &out) noexcept
+    {
+        if (!has_header(resp.header, "PDAT") || resp.header.payload_len != sizeof(pdat_payload_t))
+            return vld1_error_code_t::INVALID_DATA_RECEIVED;
+        out = resp.payload;
+        return vld1_error_code_t::OK;
+    }
+
+    // One GNFD/PDAT exchange: request a distance frame, read the RESP status
+    // and the PDAT frame. now_us is a clock returning microseconds, used to
+    // fill timing when it is given. No locking; the caller owns the transport.
+    template <byte_transport Transport, typename Clock>
+    static vld1_error_code_t request_pdat(Transport &transport, pdat_payload_t &out,
+                                          pdat_timing_t *timing, Clock now_us) noexcept
+    {
+        if (timing)
+            *timing = pdat_timing_t{};
+
+        gnfd_req_t gnfd_req{};
+        std::memcpy(gnfd_req.header.header, "GNFD", 4);
+        gnfd_req.header.payload_len = sizeof(gnfd_payload_t);
+        gnfd_req.payload = gnfd_payload_t::PDAT;
+
+        uint8_t buf[sizeof(gnfd_req_t)];
+        const size_t len = encode_frame(gnfd_req.header, reinterpret_cast<const uint8_t *>(&gnfd_req.payload),
+                                        buf, sizeof(buf));
+        transport.write(buf, len);
+        if (timing)
+            timing->gnfd_sent_us = now_us();
+
+        resp_t resp{};
+        if (transport.read_exact(reinterpret_cast<uint8_t *>(&resp), sizeof(resp_t)) != 0)
+            return vld1_error_code_t::RESP_FRAME_ERR;
+
+        const vld1_error_code_t status = decode_resp(resp);
+        if (status != vld1_error_code_t::OK)
+            return status;
+        if (timing)
+            timing->resp_received_us = now_us();
+
+        pdat_resp_t pdat_resp{};
+        if (transport.read_exact(reinterpret_cast<uint8_t *>(&pdat_resp), sizeof(pdat_resp_t)) != 0)
+            return vld1_error_code_t::RESP_FRAME_ERR;
+
+        const vld1_error_code_t err = decode_pdat(pdat_resp, out);
+        if (err == vld1_error_code_t::OK && timing)
+            timing->pdat_decoded_us = now_us();
+        return err;
+    }
+};
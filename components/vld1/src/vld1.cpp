@@ -3,8 +3,9 @@
 static constexpr char TAG[] = "VLD1";
 static constexpr char vld1_nvs_lable[] = "vld1_nvs";
 
-vld1::vld1(uart &uart_no) noexcept
-    : uart_(uart_no)
+template <byte_transport Transport>
+basic_vld1<Transport>::basic_vld1(Transport &transport) noexcept
+    : uart_(transport)
 {
     vld1_mutex_ = xSemaphoreCreateMutex();
     if (vld1_mutex_ == nullptr)
@@ -13,27 +14,25 @@ vld1::vld1(uart &uart_no) noexcept
     }
 }
 
-void vld1::send_packet(const vld1_header_t &header, const uint8_t *payload) noexcept
+template <byte_transport Transport>
+void basic_vld1<Transport>::send_packet(const vld1_header_t &header, const uint8_t *payload) noexcept
 {
-    const size_t total_len = sizeof(vld1_header_t) + header.payload_len;
-    uint8_t buf[512];
+    uint8_t buf[max_frame_len];
+    const size_t total_len = encode_frame(header, payload, buf, sizeof(buf));
 
-    if (total_len > sizeof(buf))
+    if (total_len == 0)
     {
-        ESP_LOGE(TAG, "send_packet: Packet too large (%zu > %zu)", total_len, sizeof(buf));
+        ESP_LOGE(TAG, "send_packet: Packet too large (%zu > %zu)",
+                 sizeof(vld1_header_t) + header.payload_len, sizeof(buf));
         return;
     }
 
-    std::memcpy(buf, &header, sizeof(vld1_header_t));
-
-    if (header.payload_len && payload)
-        std::memcpy(buf + sizeof(vld1_header_t), payload, header.payload_len);
-
-    ESP_LOG_BUFFER_HEXDUMP(TAG, buf, total_len, ESP_LOG_WARN);
+    ESP_LOG_BUFFER_HEXDUMP(TAG, buf, total_len, ESP_LOG_DEBUG);
     uart_.write(buf, total_len);
 }
 
-int vld1::parse_message(uint8_t *buffer, int len, char *response_code,
+template <byte_transport Transport>
+int basic_vld1<Transport>::parse_message(uint8_t *buffer, int len, char *response_code,
                         uint8_t *out_payload, uint32_t *out_len) noexcept
 {
     if (len < sizeof(vld1_header_t))
@@ -57,7 +56,8 @@ int vld1::parse_message(uint8_t *buffer, int len, char *response_code,
     return static_cast<int>(total_len);
 }
 
-esp_err_t vld1::save_config(const radar_params_t &params_struct) noexcept
+template <byte_transport Transport>
+esp_err_t basic_vld1<Transport>::save_config(const radar_params_t &params_struct) noexcept
 {
     nvs_handle_t handle;
     esp_err_t err = nvs_open(vld1_nvs_lable, NVS_READWRITE, &handle);
@@ -82,7 +82,8 @@ esp_err_t vld1::save_config(const radar_params_t &params_struct) noexcept
     return err;
 }
 
-esp_err_t vld1::restore_config(void) noexcept
+template <byte_transport Transport>
+esp_err_t basic_vld1<Transport>::restore_config(void) noexcept
 {
     nvs_handle_t handle;
     esp_err_t err = nvs_open(vld1_nvs_lable, NVS_READONLY, &handle);
@@ -110,7 +111,8 @@ esp_err_t vld1::restore_config(void) noexcept
     return err;
 }
 
-vld1::vld1_error_code_t vld1::resp_status() noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::resp_status() noexcept
 {
     resp_t resp_data{};
     esp_err_t err = uart_.read_exact(reinterpret_cast<uint8_t *>(&resp_data), sizeof(resp_t));
@@ -121,17 +123,17 @@ vld1::vld1_error_code_t vld1::resp_status() noexcept
         return vld1_error_code_t::RESP_FRAME_ERR;
     }
 
-    if (std::strncmp(resp_data.header.header, "RESP", 4) != 0 ||
-        resp_data.header.payload_len != sizeof(vld1_error_code_t))
+    const vld1_error_code_t status = decode_resp(resp_data);
+    if (status == vld1_error_code_t::RESP_FRAME_ERR)
     {
         ESP_LOGE(TAG, "Invalid response header or payload length.");
-        return vld1_error_code_t::RESP_FRAME_ERR;
+        return status;
     }
 
-    switch (resp_data.err_code)
+    switch (status)
     {
     case vld1_error_code_t::OK:
-        ESP_LOGI(TAG, "RESP: OK");
+        ESP_LOGD(TAG, "RESP: OK");
         break;
 
     case vld1_error_code_t::UNKNOWN_CMD:
@@ -164,14 +166,15 @@ vld1::vld1_error_code_t vld1::resp_status() noexcept
 
     default:
         ESP_LOGW(TAG, "RESP: Unknown error code %u",
-                 static_cast<uint8_t>(resp_data.err_code));
+                 static_cast<uint8_t>(status));
         break;
     }
 
-    return resp_data.err_code;
+    return status;
 }
 
-vld1::vld1_error_code_t vld1::get_parameters(void) noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::get_parameters(void) noexcept
 {
     scoped_lock_t lock(vld1_mutex_);
     if (!lock.locked())
@@ -242,57 +245,40 @@ vld1::vld1_error_code_t vld1::get_parameters(void) noexcept
     return vld1_error_code_t::OK;
 };
 
-vld1::vld1_error_code_t vld1::get_pdat(pdat_payload_t &pdat_data) noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::get_pdat(pdat_payload_t &pdat_data, pdat_timing_t *timing) noexcept
 {
+    if (timing)
+        *timing = pdat_timing_t{};
+
     scoped_lock_t lock(vld1_mutex_);
     if (!lock.locked())
     {
         return vld1_error_code_t::MUTEX_ERR;
     }
 
-    gnfd_req_t gnfd_req{};
-    std::memcpy(gnfd_req.header.header, "GNFD", 4);
-    gnfd_req.header.payload_len = sizeof(gnfd_payload_t);
-    gnfd_req.payload = gnfd_payload_t::PDAT;
-
-    send_packet(gnfd_req.header, reinterpret_cast<const uint8_t *>(&gnfd_req.payload));
-
-    vld1_error_code_t resp_err = resp_status();
-
-    if (resp_err != vld1_error_code_t::OK)
-        return resp_err;
-
-    pdat_resp_t pdat_resp{};
-    esp_err_t err = uart_.read_exact(reinterpret_cast<uint8_t *>(&pdat_resp), sizeof(pdat_resp_t));
-    if (err != ESP_OK)
-        return vld1_error_code_t::RESP_FRAME_ERR;
-
-    if (std::strncmp(pdat_resp.header.header, "PDAT", 4) != 0)
-    {
-        ESP_LOGE("VLD1", "Invalid PDAT header received");
-        return vld1_error_code_t::INVALID_DATA_RECEIVED;
-    }
-
-    if (pdat_resp.header.payload_len != sizeof(pdat_payload_t))
+    const vld1_error_code_t err = request_pdat(uart_, pdat_data, timing, esp_timer_get_time);
+    switch (err)
     {
-        ESP_LOGE("VLD1",
-                 "Invalid PDAT payload length: expected %zu, got %" PRIu32,
-                 sizeof(pdat_payload_t),
-                 pdat_resp.header.payload_len);
-        return vld1_error_code_t::INVALID_DATA_RECEIVED;
+    case vld1_error_code_t::OK:
+        ESP_LOGD(TAG, "PDAT: distance=%.3f m magnitude=%u", static_cast<double>(pdat_data.distance), pdat_data.magnitude);
+        break;
+    case vld1_error_code_t::RESP_FRAME_ERR:
+        ESP_LOGE(TAG, "Incomplete or invalid RESP/PDAT frame.");
+        break;
+    case vld1_error_code_t::INVALID_DATA_RECEIVED:
+        ESP_LOGE(TAG, "Invalid PDAT header or payload length.");
+        break;
+    default:
+        ESP_LOGW(TAG, "GNFD rejected: error %u", static_cast<unsigned>(err));
+        break;
     }
 
-    pdat_data = pdat_resp.payload;
-
-    ESP_LOGI("VLD1", "---------------- PDAT FRAME ----------------");
-    ESP_LOGI("VLD1", "Distance  : %.3f m", static_cast<double>(pdat_data.distance));
-    ESP_LOGI("VLD1", "Magnitude : %u", pdat_data.magnitude);
-    ESP_LOGI("VLD1", "-------------------------------------------");
-
-    return vld1_error_code_t::OK;
+    return err;
 }
 
-vld1::vld1_error_code_t vld1::init(const vld1_baud_t baud) noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::init(const vld1_baud_t baud) noexcept
 {
     scoped_lock_t lock(vld1_mutex_);
     if (!lock.locked())
@@ -329,10 +315,20 @@ vld1::vld1_error_code_t vld1::init(const vld1_baud_t baud) noexcept
     }
 
     ESP_LOGI(TAG, "VLD1 VERSION: %s", vers_resp.version);
+
+    // The sensor answers INIT at the current rate and switches afterwards.
+    const int rate = baud_rate_value(baud);
+    if (uart_.baud_rate() != rate && uart_.set_baud_rate(rate) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to switch UART to %d baud.", rate);
+        return vld1_error_code_t::UART_ERROR;
+    }
+
     return vld1_error_code_t::OK;
 }
 
-vld1::vld1_error_code_t vld1::set_radar_parameters(const radar_params_t &params_struct) noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::set_radar_parameters(const radar_params_t &params_struct) noexcept
 {
     scoped_lock_t lock(vld1_mutex_);
     if (!lock.locked())
@@ -359,7 +355,8 @@ vld1::vld1_error_code_t vld1::set_radar_parameters(const radar_params_t &params_
     return vld1_error_code_t::OK;
 }
 
-vld1::vld1_error_code_t vld1::set_distance_range(vld1_distance_range_t range) noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::set_distance_range(vld1_distance_range_t range) noexcept
 {
     scoped_lock_t lock(vld1_mutex_);
     if (!lock.locked())
@@ -384,7 +381,8 @@ vld1::vld1_error_code_t vld1::set_distance_range(vld1_distance_range_t range) no
     return vld1_error_code_t::OK;
 }
 
-vld1::vld1_error_code_t vld1::set_threshold_offset(uint8_t val) noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::set_threshold_offset(uint8_t val) noexcept
 {
     scoped_lock_t lock(vld1_mutex_);
     if (!lock.locked())
@@ -407,7 +405,8 @@ vld1::vld1_error_code_t vld1::set_threshold_offset(uint8_t val) noexcept
     return vld1_error_code_t::OK;
 }
 
-vld1::vld1_error_code_t vld1::set_min_range_filter(uint16_t val) noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::set_min_range_filter(uint16_t val) noexcept
 {
     scoped_lock_t lock(vld1_mutex_);
     if (!lock.locked())
@@ -429,7 +428,8 @@ vld1::vld1_error_code_t vld1::set_min_range_filter(uint16_t val) noexcept
     return vld1_error_code_t::OK;
 }
 
-vld1::vld1_error_code_t vld1::set_max_range_filter(uint16_t val) noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::set_max_range_filter(uint16_t val) noexcept
 {
     scoped_lock_t lock(vld1_mutex_);
     if (!lock.locked())
@@ -452,7 +452,8 @@ vld1::vld1_error_code_t vld1::set_max_range_filter(uint16_t val) noexcept
     return vld1_error_code_t::OK;
 }
 
-vld1::vld1_error_code_t vld1::set_target_filter(target_filter_t filter) noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::set_target_filter(target_filter_t filter) noexcept
 {
     scoped_lock_t lock(vld1_mutex_);
     if (!lock.locked())
@@ -477,7 +478,8 @@ vld1::vld1_error_code_t vld1::set_target_filter(target_filter_t filter) noexcept
     return vld1_error_code_t::OK;
 }
 
-vld1::vld1_error_code_t vld1::set_precision_mode(precision_mode_t mode) noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::set_precision_mode(precision_mode_t mode) noexcept
 {
     scoped_lock_t lock(vld1_mutex_);
     if (!lock.locked())
@@ -502,7 +504,8 @@ vld1::vld1_error_code_t vld1::set_precision_mode(precision_mode_t mode) noexcept
     return vld1_error_code_t::OK;
 }
 
-vld1::vld1_error_code_t vld1::exit_sequence() noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::exit_sequence() noexcept
 {
     scoped_lock_t lock(vld1_mutex_);
     if (!lock.locked())
@@ -523,7 +526,8 @@ vld1::vld1_error_code_t vld1::exit_sequence() noexcept
     return vld1_error_code_t::OK;
 }
 
-vld1::vld1_error_code_t vld1::set_chirp_integration_count(uint8_t val) noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::set_chirp_integration_count(uint8_t val) noexcept
 {
     scoped_lock_t lock(vld1_mutex_);
     if (!lock.locked())
@@ -547,7 +551,8 @@ vld1::vld1_error_code_t vld1::set_chirp_integration_count(uint8_t val) noexcept
     return vld1_error_code_t::OK;
 }
 
-vld1::vld1_error_code_t vld1::set_tx_power(uint8_t val) noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::set_tx_power(uint8_t val) noexcept
 {
     scoped_lock_t lock(vld1_mutex_);
     if (!lock.locked())
@@ -570,7 +575,8 @@ vld1::vld1_error_code_t vld1::set_tx_power(uint8_t val) noexcept
     return vld1_error_code_t::OK;
 }
 
-vld1::vld1_error_code_t vld1::set_short_range_distance_filter(short_range_distance_t state) noexcept
+template <byte_transport Transport>
+vld1_protocol::vld1_error_code_t basic_vld1<Transport>::set_short_range_distance_filter(short_range_distance_t state) noexcept
 {
     scoped_lock_t lock(vld1_mutex_);
     if (!lock.locked())
@@ -595,7 +601,27 @@ vld1::vld1_error_code_t vld1::set_short_range_distance_filter(short_range_distan
     return vld1_error_code_t::OK;
 }
 
-void vld1::vld1_flush_buffer()
+template <byte_transport Transport>
+int basic_vld1<Transport>::baud_rate_value(vld1_baud_t baud) noexcept
+{
+    switch (baud)
+    {
+    case vld1_baud_t::BAUD_460800:
+        return 460800;
+    case vld1_baud_t::BAUD_921600:
+        return 921600;
+    case vld1_baud_t::BAUD_2000000:
+        return 2000000;
+    case vld1_baud_t::BAUD_115200:
+    default:
+        return 115200;
+    }
+}
+
+template <byte_transport Transport>
+void basic_vld1<Transport>::vld1_flush_buffer() noexcept
 {
     uart_.flush_buffer();
 }
+
+template class basic_vld1<uart>;
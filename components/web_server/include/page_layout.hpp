@@ -95,5 +95,37 @@ const char g_vld1_script[] =
 const char g_vld1_form_end[] =
     "<div class=\"row\"><input type=\"button\" value=\"Submit\" onclick=\"submitForm()\"></div></form></div>";
 
+const char g_vld1_averager_start[] =
+    "<div class=\"container\"><form id=\"averagerForm\"><div class=\"row\"><label>Distance Averaging</label></div>";
+
+const char g_vld1_averager[] =
+    "<div class=\"row\"><div class=\"col-25\"><label>Window (samples)</label></div><div class=\"col-75\"><input type=\"number\" value=\"%u\" name=\"window\" min=\"1\" max=\"%u\" required></div></div>"
+    "<div class=\"row\"><div class=\"col-25\"><label>Max Step (m)</label></div><div class=\"col-75\"><input type=\"number\" value=\"%.3f\" name=\"max_step_m\" min=\"0.001\" max=\"10\" step=\"0.001\" required></div></div>"
+    "<div class=\"row\"><div class=\"col-25\"><label>Hampel Threshold (MAD)</label></div><div class=\"col-75\"><input type=\"number\" value=\"%.2f\" name=\"hampel_thresh\" min=\"0.5\" max=\"20\" step=\"0.1\" required></div></div>"
+    "<div class=\"row\"><div class=\"col-25\"><label>Trim Fraction</label></div><div class=\"col-75\"><input type=\"number\" value=\"%.2f\" name=\"trim_fraction\" min=\"0\" max=\"0.45\" step=\"0.01\" required></div></div>"
+    "<div class=\"row\"><div class=\"col-25\"><label>Settling (samples)</label></div><div class=\"col-75\"><input type=\"number\" value=\"%u\" name=\"reacquire_count\" min=\"1\" max=\"%u\" required></div></div>";
+
+const char g_vld1_averager_end[] =
+    "<div class=\"row\"><input type=\"button\" value=\"Apply\" onclick=\"submitAverager()\"></div></form></div>";
+
+const char g_vld1_averager_script[] =
+    "<script>function submitAverager(){const form=document.getElementById('averagerForm');const data={};"
+    "for(const e of form.elements)if(e.name)data[e.name]=Number(e.value);"
+    "fetch('/averager_config',{method:'POST',headers:{'Content-Type':'application/json'},body:JSON.stringify(data)})"
+    ".then(r=>alert(r.ok?'Averager updated!':'Update failed!'));}</script>";
+
+const char g_vld1_stats[] =
+    "<div class=\"container\"><div class=\"row\"><label>Jitter (<span id=\"frames\">0</span> frames)</label></div>"
+    "<table style=\"width:100%;text-align:right\"><tr><th></th><th>p50</th><th>p95</th><th>p99</th></tr>"
+    "<tr><th style=\"text-align:left\">Deviation (mm)</th><td id=\"dev_p50\"></td><td id=\"dev_p95\"></td><td id=\"dev_p99\"></td></tr>"
+    "<tr><th style=\"text-align:left\">Frame interval (ms)</th><td id=\"int_p50\"></td><td id=\"int_p95\"></td><td id=\"int_p99\"></td></tr></table>"
+    "<div class=\"row\"><input type=\"button\" value=\"Reset\" onclick=\"resetStats()\"></div></div>"
+    "<script>function loadStats(){fetch('/stats').then(r=>r.json()).then(s=>{const j=s.jitter;"
+    "document.getElementById('frames').textContent=j.frames;"
+    "for(const[k,v]of[['dev',j.deviation_mm],['int',j.interval_ms]])for(const p of['p50','p95','p99'])"
+    "document.getElementById(k+'_'+p).textContent=v[p].toFixed(1);}).catch(()=>{});}"
+    "function resetStats(){fetch('/stats/reset',{method:'POST'}).then(loadStats);}"
+    "loadStats();setInterval(loadStats,2000);</script>";
+
 const char g_footer[] =
     "<footer class=\"footer\">&#169 2025 Real Time Solutions Pvt. Ltd.</footer></body></html>";
@@ -10,6 +10,7 @@
 #include "esp_http_server.h"
 #include "page_layout.hpp"
 #include "vld1.hpp"
+#include "telemetry.hpp"
 #include <cstring>
 #include <memory>
 #include <string>
@@ -17,10 +18,13 @@
 class web_server
 {
 public:
-    web_server(vld1 &sensor) noexcept;
+    web_server(vld1 &sensor, telemetry &stats) noexcept;
     ~web_server();
 
-    esp_err_t init();
+    // The HTTP server task is created with this core, priority and stack
+    esp_err_t init(BaseType_t core_id = tskNO_AFFINITY,
+                   UBaseType_t task_priority = tskIDLE_PRIORITY + 5,
+                   size_t stack_size = 4096);
     void deinit();
 
     const std::string &get_ssid() const { return ssid_; }
@@ -36,10 +40,17 @@ private:
 
     static esp_err_t handle_root(httpd_req_t *req);
     static esp_err_t handle_post_config(httpd_req_t *req);
+    static esp_err_t handle_get_stats(httpd_req_t *req);
+    static esp_err_t handle_post_averager(httpd_req_t *req);
+    static esp_err_t handle_get_trace(httpd_req_t *req);
+    static esp_err_t handle_post_stats_reset(httpd_req_t *req);
+    static esp_err_t receive_json(httpd_req_t *req, cJSON **root);
+    static esp_err_t send_json(httpd_req_t *req, cJSON *response);
     static void *get_server_from_req(httpd_req_t *req);
 
     httpd_handle_t server_;
     vld1 &sensor_;
+    telemetry &stats_;
     std::string ssid_;
     std::string password_;
     std::string ip_;
@@ -1,10 +1,12 @@
 #include "web_server.hpp"
+#include <new>
 
 static constexpr char TAG[] = "web_server";
 
-web_server::web_server(vld1 &sensor) noexcept
+web_server::web_server(vld1 &sensor, telemetry &stats) noexcept
     : server_(nullptr),
       sensor_(sensor),
+      stats_(stats),
       ssid_("ESP-RLS"),
       password_("rtsdevice123*#"),
       ip_("192.168.4.1"),
@@ -64,7 +66,7 @@ void web_server::update_ip_address()
     }
 }
 
-esp_err_t web_server::init()
+esp_err_t web_server::init(BaseType_t core_id, UBaseType_t task_priority, size_t stack_size)
 {
 
     if (is_initialized_)
@@ -82,6 +84,9 @@ esp_err_t web_server::init()
 
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.server_port = 80;
+    config.core_id = core_id;
+    config.task_priority = task_priority;
+    config.stack_size = stack_size;
 
     ret = httpd_start(&server_, &config);
     if (ret != ESP_OK)
@@ -130,6 +135,34 @@ void web_server::register_handlers()
         .handler = handle_post_config,
         .user_ctx = this};
     httpd_register_uri_handler(server_, &post_uri);
+
+    httpd_uri_t stats_uri = {
+        .uri = "/stats",
+        .method = HTTP_GET,
+        .handler = handle_get_stats,
+        .user_ctx = this};
+    httpd_register_uri_handler(server_, &stats_uri);
+
+    httpd_uri_t averager_uri = {
+        .uri = "/averager_config",
+        .method = HTTP_POST,
+        .handler = handle_post_averager,
+        .user_ctx = this};
+    httpd_register_uri_handler(server_, &averager_uri);
+
+    httpd_uri_t trace_uri = {
+        .uri = "/trace",
+        .method = HTTP_GET,
+        .handler = handle_get_trace,
+        .user_ctx = this};
+    httpd_register_uri_handler(server_, &trace_uri);
+
+    httpd_uri_t stats_reset_uri = {
+        .uri = "/stats/reset",
+        .method = HTTP_POST,
+        .handler = handle_post_stats_reset,
+        .user_ctx = this};
+    httpd_register_uri_handler(server_, &stats_reset_uri);
 }
 
 esp_err_t web_server::handle_root(httpd_req_t *req)
@@ -261,6 +294,38 @@ esp_err_t web_server::serve_config_page(httpd_req_t *req, const vld1::radar_para
     if (ret != ESP_OK)
         return ret;
 
+    telemetry::averager_settings_t averager{};
+    if (stats_.averager_settings(averager))
+    {
+        ret = httpd_resp_sendstr_chunk(req, g_vld1_averager_start);
+        if (ret != ESP_OK)
+            return ret;
+
+        const int len = snprintf(buffer, sizeof(buffer), g_vld1_averager, averager.window, averager.capacity,
+                                 averager.max_step_m, averager.hampel_thresh, averager.trim_fraction,
+                                 averager.reacquire_count, averager.reacquire_max);
+        if (len < 0 || static_cast<size_t>(len) >= sizeof(buffer))
+        {
+            ESP_LOGE(TAG, "Averager form needs %d bytes, page buffer has %u", len, static_cast<unsigned>(sizeof(buffer)));
+            return ESP_ERR_INVALID_SIZE;
+        }
+        ret = httpd_resp_sendstr_chunk(req, buffer);
+        if (ret != ESP_OK)
+            return ret;
+
+        ret = httpd_resp_sendstr_chunk(req, g_vld1_averager_end);
+        if (ret != ESP_OK)
+            return ret;
+
+        ret = httpd_resp_sendstr_chunk(req, g_vld1_averager_script);
+        if (ret != ESP_OK)
+            return ret;
+    }
+
+    ret = httpd_resp_sendstr_chunk(req, g_vld1_stats);
+    if (ret != ESP_OK)
+        return ret;
+
     ret = httpd_resp_sendstr_chunk(req, g_footer);
     if (ret != ESP_OK)
         return ret;
@@ -268,16 +333,8 @@ esp_err_t web_server::serve_config_page(httpd_req_t *req, const vld1::radar_para
     return httpd_resp_sendstr_chunk(req, NULL);
 }
 
-esp_err_t web_server::handle_post_config(httpd_req_t *req)
+esp_err_t web_server::receive_json(httpd_req_t *req, cJSON **root)
 {
-    auto *self = static_cast<web_server *>(req->user_ctx);
-    if (!self)
-    {
-        ESP_LOGE(TAG, "User context is NULL");
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Internal server error");
-        return ESP_FAIL;
-    }
-
     size_t remaining = req->content_len;
     std::unique_ptr<char[]> buf(new char[remaining + 1]);
     char *p = buf.get();
@@ -302,13 +359,50 @@ esp_err_t web_server::handle_post_config(httpd_req_t *req)
 
     ESP_LOGI(TAG, "Received POST data: %s", buf.get());
 
-    cJSON *root = cJSON_Parse(buf.get());
-    if (!root)
+    *root = cJSON_Parse(buf.get());
+    if (!*root)
     {
         ESP_LOGE(TAG, "Invalid JSON payload");
         httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid JSON");
         return ESP_FAIL;
     }
+    return ESP_OK;
+}
+
+esp_err_t web_server::send_json(httpd_req_t *req, cJSON *response)
+{
+    char *response_str = cJSON_PrintUnformatted(response);
+    if (!response_str)
+    {
+        cJSON_Delete(response);
+        ESP_LOGE(TAG, "Failed to serialize JSON response");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to create response");
+        return ESP_FAIL;
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    esp_err_t http_ret = httpd_resp_send(req, response_str, HTTPD_RESP_USE_STRLEN);
+
+    cJSON_free(response_str);
+    cJSON_Delete(response);
+
+    return http_ret;
+}
+
+esp_err_t web_server::handle_post_config(httpd_req_t *req)
+{
+    auto *self = static_cast<web_server *>(req->user_ctx);
+    if (!self)
+    {
+        ESP_LOGE(TAG, "User context is NULL");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Internal server error");
+        return ESP_FAIL;
+    }
+
+    cJSON *root = nullptr;
+    if (receive_json(req, &root) != ESP_OK)
+        return ESP_FAIL;
 
     auto get_str = [&](const char *key) -> std::string
     {
@@ -429,21 +523,287 @@ esp_err_t web_server::handle_post_config(httpd_req_t *req)
         cJSON_AddStringToObject(response, "error_code", error_name);
     }
 
-    char *response_str = cJSON_PrintUnformatted(response);
-    if (!response_str)
+    return send_json(req, response);
+}
+esp_err_t web_server::handle_get_stats(httpd_req_t *req)
+{
+    auto *self = static_cast<web_server *>(req->user_ctx);
+    if (!self)
     {
-        cJSON_Delete(response);
-        ESP_LOGE(TAG, "Failed to serialize JSON response");
+        ESP_LOGE(TAG, "User context is NULL");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Internal server error");
+        return ESP_FAIL;
+    }
+
+    const telemetry::jitter_stats_t jitter = self->stats_.jitter();
+
+    cJSON *response = cJSON_CreateObject();
+    if (!response)
+    {
+        ESP_LOGE(TAG, "Failed to create JSON response");
         httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to create response");
         return ESP_FAIL;
     }
 
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-    esp_err_t http_ret = httpd_resp_send(req, response_str, HTTPD_RESP_USE_STRLEN);
+    auto add_quantiles = [](cJSON *parent, const char *name, const telemetry::quantiles_t &q)
+    {
+        cJSON *obj = cJSON_CreateObject();
+        cJSON_AddNumberToObject(obj, "p50", q.p50);
+        cJSON_AddNumberToObject(obj, "p95", q.p95);
+        cJSON_AddNumberToObject(obj, "p99", q.p99);
+        cJSON_AddItemToObject(parent, name, obj);
+    };
 
-    cJSON_free(response_str);
-    cJSON_Delete(response);
+    cJSON *jitter_obj = cJSON_CreateObject();
+    cJSON_AddNumberToObject(jitter_obj, "frames", jitter.frames);
+    add_quantiles(jitter_obj, "deviation_mm", jitter.deviation_mm);
+    add_quantiles(jitter_obj, "interval_ms", jitter.interval_ms);
+    cJSON_AddItemToObject(response, "jitter", jitter_obj);
+
+    const telemetry::pipeline_stats_t pipeline = self->stats_.pipeline();
+    cJSON *pipeline_obj = cJSON_CreateObject();
+    cJSON_AddNumberToObject(pipeline_obj, "queued", pipeline.queued);
+    cJSON_AddNumberToObject(pipeline_obj, "dropped", pipeline.dropped);
+    cJSON_AddNumberToObject(pipeline_obj, "backpressure_waits", pipeline.backpressure_waits);
+    cJSON_AddNumberToObject(pipeline_obj, "queue_high_water", pipeline.queue_high_water);
+    cJSON_AddItemToObject(response, "pipeline", pipeline_obj);
+
+    cJSON *averager_obj = cJSON_CreateObject();
+    cJSON_AddNumberToObject(averager_obj, "weak_samples", self->stats_.weak_samples());
+    cJSON_AddItemToObject(response, "averager", averager_obj);
+
+    telemetry::schedule_stats_t schedule{};
+    if (self->stats_.schedule(schedule))
+    {
+        cJSON *schedule_obj = cJSON_CreateObject();
+        cJSON_AddNumberToObject(schedule_obj, "rate_hz", schedule.rate_hz);
+        cJSON_AddNumberToObject(schedule_obj, "achieved_hz", schedule.achieved_hz);
+        cJSON_AddNumberToObject(schedule_obj, "cycles", schedule.cycles);
+        cJSON_AddNumberToObject(schedule_obj, "overruns", schedule.overruns);
+        cJSON_AddNumberToObject(schedule_obj, "jitter_rms_us", schedule.jitter_rms_us);
+        cJSON_AddNumberToObject(schedule_obj, "jitter_max_us", schedule.jitter_max_us);
+        cJSON_AddItemToObject(response, "schedule", schedule_obj);
+    }
 
-    return http_ret;
-}
\ No newline at end of file
+    telemetry::health_stats_t health{};
+    if (self->stats_.health(health))
+    {
+        cJSON *health_obj = cJSON_CreateObject();
+        cJSON_AddBoolToObject(health_obj, "sensor_ok", health.sensor_ok);
+        cJSON_AddNumberToObject(health_obj, "consecutive_failures", health.consecutive_failures);
+        cJSON_AddNumberToObject(health_obj, "failures", health.failures);
+        cJSON_AddNumberToObject(health_obj, "outages", health.outages);
+        cJSON_AddNumberToObject(health_obj, "backoff_ms", health.backoff_ms);
+        cJSON_AddNumberToObject(health_obj, "last_outage_ms", health.last_outage_ms);
+        cJSON_AddNumberToObject(health_obj, "last_recovery_ms", health.last_recovery_ms);
+        cJSON_AddNumberToObject(health_obj, "max_recovery_ms", health.max_recovery_ms);
+        cJSON_AddItemToObject(response, "health", health_obj);
+    }
+
+    telemetry::reacquisition_stats_t reacquisition{};
+    if (self->stats_.reacquisition(reacquisition))
+    {
+        cJSON *reacquisition_obj = cJSON_CreateObject();
+        cJSON_AddNumberToObject(reacquisition_obj, "count", reacquisition.reacquisitions);
+        cJSON_AddNumberToObject(reacquisition_obj, "last_settling_samples", reacquisition.last_settling_samples);
+        cJSON_AddNumberToObject(reacquisition_obj, "last_settling_ms", reacquisition.last_settling_ms);
+        cJSON_AddNumberToObject(reacquisition_obj, "max_settling_ms", reacquisition.max_settling_ms);
+        cJSON_AddItemToObject(response, "reacquisition", reacquisition_obj);
+    }
+
+    telemetry::serial_stats_t serial{};
+    if (self->stats_.serial(serial))
+    {
+        cJSON *serial_obj = cJSON_CreateObject();
+        cJSON_AddNumberToObject(serial_obj, "frames", serial.frames);
+        cJSON_AddNumberToObject(serial_obj, "last_us", serial.last_us);
+        cJSON_AddNumberToObject(serial_obj, "mean_us", serial.mean_us);
+        cJSON_AddNumberToObject(serial_obj, "max_us", serial.max_us);
+        cJSON_AddItemToObject(response, "sensor_uart", serial_obj);
+    }
+
+    cJSON *latency_obj = cJSON_CreateObject();
+    for (size_t i = 0; i < telemetry::latency_stage_count; ++i)
+    {
+        const auto stage = static_cast<telemetry::latency_stage_t>(i);
+        const latency_histogram hist = self->stats_.latency(stage);
+        cJSON *stage_obj = cJSON_CreateObject();
+        cJSON_AddNumberToObject(stage_obj, "count", hist.count());
+        cJSON_AddNumberToObject(stage_obj, "mean_us", hist.mean_us());
+        cJSON_AddNumberToObject(stage_obj, "p50_us", hist.quantile_us(0.50f));
+        cJSON_AddNumberToObject(stage_obj, "p95_us", hist.quantile_us(0.95f));
+        cJSON_AddNumberToObject(stage_obj, "p99_us", hist.quantile_us(0.99f));
+        cJSON_AddNumberToObject(stage_obj, "max_us", hist.max_us());
+        cJSON_AddItemToObject(latency_obj, telemetry::latency_stage_name(stage), stage_obj);
+    }
+    cJSON_AddItemToObject(response, "latency", latency_obj);
+
+    telemetry::measurement_t latest{};
+    if (self->stats_.latest(latest))
+    {
+        cJSON *latest_obj = cJSON_CreateObject();
+        cJSON_AddNumberToObject(latest_obj, "timestamp_us", static_cast<double>(latest.timestamp_us));
+        cJSON_AddNumberToObject(latest_obj, "distance_m", latest.distance_m);
+        cJSON_AddNumberToObject(latest_obj, "average_m", latest.average_m);
+        cJSON_AddNumberToObject(latest_obj, "magnitude", latest.magnitude);
+        cJSON_AddNumberToObject(latest_obj, "error", latest.error);
+        cJSON_AddItemToObject(response, "latest", latest_obj);
+    }
+
+    return send_json(req, response);
+}
+
+// Full latency histograms plus the newest frame traces
+esp_err_t web_server::handle_get_trace(httpd_req_t *req)
+{
+    auto *self = static_cast<web_server *>(req->user_ctx);
+    if (!self)
+    {
+        ESP_LOGE(TAG, "User context is NULL");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Internal server error");
+        return ESP_FAIL;
+    }
+
+    std::unique_ptr<telemetry::frame_trace_t[]> traces(new (std::nothrow) telemetry::frame_trace_t[telemetry::trace_length]);
+    cJSON *response = traces ? cJSON_CreateObject() : nullptr;
+    if (!response)
+    {
+        ESP_LOGE(TAG, "Failed to create JSON response");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to create response");
+        return ESP_FAIL;
+    }
+
+    // Bucket i counts latencies from bucket_floor_us[i] up to the next floor
+    int floors[latency_histogram::bucket_count];
+    for (size_t i = 0; i < latency_histogram::bucket_count; ++i)
+        floors[i] = static_cast<int>(latency_histogram::bucket_floor_us(i));
+    cJSON_AddItemToObject(response, "bucket_floor_us", cJSON_CreateIntArray(floors, static_cast<int>(latency_histogram::bucket_count)));
+
+    cJSON *histograms = cJSON_CreateObject();
+    for (size_t i = 0; i < telemetry::latency_stage_count; ++i)
+    {
+        const auto stage = static_cast<telemetry::latency_stage_t>(i);
+        const latency_histogram hist = self->stats_.latency(stage);
+        int counts[latency_histogram::bucket_count];
+        for (size_t b = 0; b < latency_histogram::bucket_count; ++b)
+            counts[b] = static_cast<int>(hist.bucket(b));
+        cJSON_AddItemToObject(histograms, telemetry::latency_stage_name(stage),
+                              cJSON_CreateIntArray(counts, static_cast<int>(latency_histogram::bucket_count)));
+    }
+    cJSON_AddItemToObject(response, "histograms", histograms);
+
+    // Stage timestamps relative to the GNFD request, newest frame first
+    auto offset = [](int64_t from_us, int64_t to_us) -> double
+    { return (from_us > 0 && to_us > 0) ? static_cast<double>(to_us - from_us) : -1.0; };
+
+    const size_t n = self->stats_.traces(traces.get(), telemetry::trace_length);
+    cJSON *frames = cJSON_CreateArray();
+    for (size_t i = 0; i < n; ++i)
+    {
+        const telemetry::frame_trace_t &t = traces[i];
+        cJSON *frame = cJSON_CreateObject();
+        cJSON_AddNumberToObject(frame, "sequence", t.sequence);
+        cJSON_AddNumberToObject(frame, "gnfd_sent_us", static_cast<double>(t.gnfd_sent_us));
+        cJSON_AddNumberToObject(frame, "resp_received", offset(t.gnfd_sent_us, t.resp_received_us));
+        cJSON_AddNumberToObject(frame, "pdat_decoded", offset(t.gnfd_sent_us, t.pdat_decoded_us));
+        cJSON_AddNumberToObject(frame, "averaged", offset(t.gnfd_sent_us, t.averaged_us));
+        cJSON_AddNumberToObject(frame, "registers", offset(t.gnfd_sent_us, t.registers_us));
+        cJSON_AddNumberToObject(frame, "first_read", offset(t.gnfd_sent_us, t.first_read_us));
+        cJSON_AddItemToArray(frames, frame);
+    }
+    cJSON_AddItemToObject(response, "frames", frames);
+
+    return send_json(req, response);
+}
+
+// Start the jitter quantiles and latency histograms afresh, e.g. after a
+// configuration change, so they describe the current setup only
+esp_err_t web_server::handle_post_stats_reset(httpd_req_t *req)
+{
+    auto *self = static_cast<web_server *>(req->user_ctx);
+    if (!self)
+    {
+        ESP_LOGE(TAG, "User context is NULL");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Internal server error");
+        return ESP_FAIL;
+    }
+
+    self->stats_.reset_jitter();
+    self->stats_.reset_latency();
+    ESP_LOGI(TAG, "Statistics reset");
+
+    cJSON *response = cJSON_CreateObject();
+    if (!response)
+    {
+        ESP_LOGE(TAG, "Failed to create JSON response");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to create response");
+        return ESP_FAIL;
+    }
+
+    cJSON_AddStringToObject(response, "status", "success");
+    cJSON_AddStringToObject(response, "message", "Statistics reset");
+    return send_json(req, response);
+}
+
+esp_err_t web_server::handle_post_averager(httpd_req_t *req)
+{
+    auto *self = static_cast<web_server *>(req->user_ctx);
+    if (!self)
+    {
+        ESP_LOGE(TAG, "User context is NULL");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Internal server error");
+        return ESP_FAIL;
+    }
+
+    telemetry::averager_settings_t settings{};
+    if (!self->stats_.averager_settings(settings))
+    {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Averager not running");
+        return ESP_FAIL;
+    }
+
+    cJSON *root = nullptr;
+    if (receive_json(req, &root) != ESP_OK)
+        return ESP_FAIL;
+
+    auto get_num = [&](const char *key, double default_val) -> double
+    {
+        const cJSON *item = cJSON_GetObjectItem(root, key);
+        return cJSON_IsNumber(item) ? item->valuedouble : default_val;
+    };
+
+    const double window = get_num("window", settings.window);
+    const double max_step = get_num("max_step_m", settings.max_step_m);
+    const double hampel = get_num("hampel_thresh", settings.hampel_thresh);
+    const double trim = get_num("trim_fraction", settings.trim_fraction);
+    const double reacquire = get_num("reacquire_count", settings.reacquire_count);
+    cJSON_Delete(root);
+
+    if (window < 1 || window > settings.capacity || max_step <= 0.0 || max_step > 10.0 ||
+        hampel <= 0.0 || hampel > 20.0 || trim < 0.0 || trim > 0.45 ||
+        reacquire < 1 || reacquire > settings.reacquire_max)
+    {
+        ESP_LOGE(TAG, "Averager settings out of range");
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Averager settings out of range");
+        return ESP_FAIL;
+    }
+
+    settings.window = static_cast<uint16_t>(window);
+    settings.max_step_m = static_cast<float>(max_step);
+    settings.hampel_thresh = static_cast<float>(hampel);
+    settings.trim_fraction = static_cast<float>(trim);
+    settings.reacquire_count = static_cast<uint16_t>(reacquire);
+    self->stats_.request_averager_settings(settings);
+
+    cJSON *response = cJSON_CreateObject();
+    if (!response)
+    {
+        ESP_LOGE(TAG, "Failed to create JSON response");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to create response");
+        return ESP_FAIL;
+    }
+
+    cJSON_AddStringToObject(response, "status", "success");
+    cJSON_AddStringToObject(response, "message", "Averager settings queued");
+    return send_json(req, response);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+
+// Retry pacing for a polled device that may disappear. After a failure the
+// next attempt is held back by a delay that doubles per consecutive failure,
+// from min_ms up to max_ms; at the cap the attempts become periodic health
+// probes. The first success clears the backoff, so the caller is back at
+// full rate on the very next cycle.
+//
+// Each outage is measured: its length from the first failure to the first
+// success, and the recovery time from the last failed probe to the success.
+// The device came back somewhere in that last gap, so the recovery time
+// bounds how long a reconnect goes unnoticed.
+class error_backoff
+{
+public:
+    error_backoff(uint32_t min_ms, uint32_t max_ms) noexcept
+        : min_us_(int64_t(min_ms) * 1000), max_us_(int64_t(max_ms) * 1000)
+    {
+    }
+
+    // True if an attempt may be made at now_us
+    bool attempt_due(int64_t now_us) const noexcept { return now_us >= next_attempt_us_; }
+
+    int64_t until_attempt_us(int64_t now_us) const noexcept
+    {
+        return now_us < next_attempt_us_ ? next_attempt_us_ - now_us : 0;
+    }
+
+    void on_failure(int64_t now_us) noexcept
+    {
+        if (consecutive_failures_ == 0)
+            outage_start_us_ = now_us;
+        ++consecutive_failures_;
+        ++failures_;
+
+        delay_us_ = delay_us_ == 0 ? min_us_ : delay_us_ * 2;
+        if (delay_us_ > max_us_)
+            delay_us_ = max_us_;
+
+        last_failure_us_ = now_us;
+        next_attempt_us_ = now_us + delay_us_;
+    }
+
+    // Returns true if this success ended an outage
+    bool on_success(int64_t now_us) noexcept
+    {
+        if (consecutive_failures_ == 0)
+            return false;
+
+        last_outage_us_ = now_us - outage_start_us_;
+        last_recovery_us_ = now_us - last_failure_us_;
+        if (last_recovery_us_ > max_recovery_us_)
+            max_recovery_us_ = last_recovery_us_;
+        ++outages_;
+
+        consecutive_failures_ = 0;
+        delay_us_ = 0;
+        next_attempt_us_ = 0;
+        return true;
+    }
+
+    bool failing() const noexcept { return consecutive_failures_ > 0; }
+    bool at_max_delay() const noexcept { return delay_us_ >= max_us_; }
+
+    uint32_t consecutive_failures() const noexcept { return consecutive_failures_; }
+    uint32_t failures() const noexcept { return failures_; }
+    uint32_t outages() const noexcept { return outages_; }
+    int64_t delay_us() const noexcept { return delay_us_; }
+    int64_t last_outage_us() const noexcept { return last_outage_us_; }
+    int64_t last_recovery_us() const noexcept { return last_recovery_us_; }
+    int64_t max_recovery_us() const noexcept { return max_recovery_us_; }
+
+private:
+    int64_t min_us_;
+    int64_t max_us_;
+    int64_t delay_us_ = 0;
+    int64_t next_attempt_us_ = 0;
+    int64_t outage_start_us_ = 0;
+    int64_t last_failure_us_ = 0;
+    int64_t last_outage_us_ = 0;
+    int64_t last_recovery_us_ = 0;
+    int64_t max_recovery_us_ = 0;
+    uint32_t consecutive_failures_ = 0;
+    uint32_t failures_ = 0;
+    uint32_t outages_ = 0;
+};
@@ -0,0 +1,134 @@
+#include "rate_scheduler.hpp"
+#include "esp_log.h"
+#include <cinttypes>
+#include <cmath>
+#include <cstdlib>
+
+static constexpr char TAG[] = "Scheduler";
+
+rate_scheduler::rate_scheduler(uint32_t rate_hz) noexcept
+    : rate_hz_(rate_hz),
+      period_us_(rate_hz > 0 ? 1000000 / rate_hz : 0),
+      timer_(nullptr),
+      task_(nullptr),
+      first_us_(-1),
+      last_us_(-1),
+      mean_period_us_(static_cast<float>(period_us_)),
+      cycles_(0),
+      overruns_(0),
+      jitter_sq_sum_(0.0),
+      jitter_samples_(0),
+      jitter_max_us_(0)
+{
+}
+
+rate_scheduler::~rate_scheduler()
+{
+    if (timer_)
+    {
+        esp_timer_stop(timer_);
+        esp_timer_delete(timer_);
+    }
+}
+
+esp_err_t rate_scheduler::start() noexcept
+{
+    task_ = xTaskGetCurrentTaskHandle();
+    if (rate_hz_ == 0)
+    {
+        ESP_LOGI(TAG, "Free-running (no fixed rate).");
+        return ESP_OK;
+    }
+
+    const esp_timer_create_args_t args = {
+        .callback = on_period,
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "rate_scheduler",
+        .skip_unhandled_events = false,
+    };
+    esp_err_t ret = esp_timer_create(&args, &timer_);
+    if (ret == ESP_OK)
+    {
+        ret = esp_timer_start_periodic(timer_, static_cast<uint64_t>(period_us_));
+        if (ret != ESP_OK)
+        {
+            esp_timer_delete(timer_);
+            timer_ = nullptr;
+        }
+    }
+    if (ret != ESP_OK)
+    {
+        // wait() must not block on a timer that never fires: run free and
+        // measure jitter against the observed period instead.
+        ESP_LOGE(TAG, "Failed to start scheduler timer: %s", esp_err_to_name(ret));
+        timer_ = nullptr;
+        rate_hz_ = 0;
+        period_us_ = 0;
+        mean_period_us_ = 0.0f;
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Running at %" PRIu32 " Hz (period %" PRId64 " us).", rate_hz_, period_us_);
+    return ESP_OK;
+}
+
+void rate_scheduler::on_period(void *arg)
+{
+    auto *self = static_cast<rate_scheduler *>(arg);
+    xTaskNotifyGive(self->task_);
+}
+
+void rate_scheduler::wait() noexcept
+{
+    if (timer_)
+    {
+        // Each timer period adds one notification; more than one pending
+        // means the last cycle overran and those periods were skipped.
+        const uint32_t due = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (due > 1)
+            overruns_ += due - 1;
+    }
+    else
+    {
+        // Free-running: the sensor exchange itself paces the loop
+        taskYIELD();
+    }
+
+    record_cycle(esp_timer_get_time());
+}
+
+void rate_scheduler::record_cycle(int64_t now_us) noexcept
+{
+    ++cycles_;
+    if (first_us_ < 0)
+        first_us_ = now_us;
+
+    if (last_us_ >= 0)
+    {
+        const float period = static_cast<float>(now_us - last_us_);
+        if (period_us_ == 0)
+            mean_period_us_ = jitter_samples_ == 0 ? period : mean_period_us_ + 0.05f * (period - mean_period_us_);
+
+        const float jitter = period - mean_period_us_;
+        jitter_sq_sum_ += static_cast<double>(jitter) * jitter;
+        ++jitter_samples_;
+        const uint32_t abs_jitter = static_cast<uint32_t>(std::fabs(jitter));
+        if (abs_jitter > jitter_max_us_)
+            jitter_max_us_ = abs_jitter;
+    }
+    last_us_ = now_us;
+}
+
+rate_scheduler::stats_t rate_scheduler::stats() const noexcept
+{
+    stats_t s{};
+    s.cycles = cycles_;
+    s.overruns = overruns_;
+    if (cycles_ > 1 && last_us_ > first_us_)
+        s.achieved_hz = static_cast<float>(cycles_ - 1) * 1e6f / static_cast<float>(last_us_ - first_us_);
+    if (jitter_samples_ > 0)
+        s.jitter_rms_us = static_cast<float>(std::sqrt(jitter_sq_sum_ / jitter_samples_));
+    s.jitter_max_us = jitter_max_us_;
+    return s;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include <cstdint>
+
+// Paces a task at a fixed rate. An esp_timer fires every period and notifies
+// the task, so the start of each cycle does not depend on how long the
+// previous one took, and the period is not rounded to the FreeRTOS tick.
+// With a rate of 0 the task runs free and the scheduler only measures.
+class rate_scheduler
+{
+public:
+    struct stats_t
+    {
+        uint32_t cycles;        // Cycles since start
+        uint32_t overruns;      // Periods missed because a cycle ran long
+        float achieved_hz;      // Cycles per second since start
+        float jitter_rms_us;    // RMS deviation of the period from nominal
+        uint32_t jitter_max_us; // Largest deviation of the period from nominal
+    };
+
+    explicit rate_scheduler(uint32_t rate_hz) noexcept;
+    ~rate_scheduler();
+
+    // Start pacing the calling task
+    esp_err_t start() noexcept;
+
+    // Block until the next cycle is due
+    void wait() noexcept;
+
+    stats_t stats() const noexcept;
+    uint32_t rate_hz() const noexcept { return rate_hz_; }
+
+private:
+    static void on_period(void *arg);
+    void record_cycle(int64_t now_us) noexcept;
+
+    uint32_t rate_hz_;
+    int64_t period_us_;
+    esp_timer_handle_t timer_;
+    TaskHandle_t task_;
+
+    int64_t first_us_;
+    int64_t last_us_;
+    float mean_period_us_; // nominal period, or its running estimate when free-running
+    uint32_t cycles_;
+    uint32_t overruns_;
+    double jitter_sq_sum_;
+    uint32_t jitter_samples_;
+    uint32_t jitter_max_us_;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free ring for exactly one producer task and one consumer task. Each
+// side only writes its own index, so push() and pop() never block or take a
+// lock; a full ring makes push() fail and leaves the decision to the caller.
+template <typename T, size_t N>
+class spsc_ring
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "spsc_ring capacity must be a power of two");
+
+public:
+    // Producer side
+    bool push(const T &value) noexcept
+    {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == N)
+            return false;
+
+        slots_[head & (N - 1)] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T &value) noexcept
+    {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+            return false;
+
+        value = slots_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Occupancy as seen by the caller; exact only on the consumer side
+    size_t size() const noexcept
+    {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    bool full() const noexcept { return size() == N; }
+    static constexpr size_t capacity() noexcept { return N; }
+
+private:
+    std::array<T, N> slots_{};
+    std::atomic<uint32_t> head_{0}; // written by the producer only
+    std::atomic<uint32_t> tail_{0}; // written by the consumer only
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cstdint>
+
+// Where each task runs. The sensor path sits on core 1 so radio bursts cannot
+// delay a PDAT request; everything network- or bus-facing stays on core 0.
+// Defaults, highest priority first (IDF and esp-modbus tasks are placed
+// through their own sdkconfig options and only listed here):
+//
+//   core 0  Wi-Fi           23  CONFIG_ESP_WIFI_TASK_PINNED_TO_CORE_0
+//           esp_timer       22  CONFIG_ESP_TIMER_TASK_AFFINITY; fires the
+//                               acquisition pacing timer
+//           lwIP tcpip      18  CONFIG_LWIP_TCPIP_TASK_AFFINITY
+//           port_serial     10  CONFIG_FMB_PORT_TASK_PRIO/_AFFINITY, RS485 frames
+//           mbc_ser_slave    9  Modbus controller, one below the port task
+//           httpd            5  APP_HTTPD_TASK_*
+//           MB_reads         4  APP_MODBUS_WATCH_TASK_*
+//   core 1  PDAT_acquire     7  APP_ACQUISITION_TASK_*
+//           PDAT_process     5  APP_PROCESSING_TASK_*
+//
+// Logging is not a task: ESP_LOG writes to the console UART synchronously in
+// the task that logs. The per-frame INFO line of PDAT_process holds that task
+// for several ms at 115200 baud, which is why it ranks below acquisition; set
+// CONFIG_LOG_DEFAULT_LEVEL to WARN where the processing headroom matters.
+//
+// The pinned placement follows from which tasks share core 0. It has not been
+// measured against an unpinned topology: that needs Wi-Fi and httpd load on a
+// real unit and is outside the scope of this code. To take it, build once as
+// is and once with APP_TASK_TOPOLOGY_UNPINNED, load the link (e.g. poll
+// /trace in a loop), POST /stats/reset, and after a few minutes record
+// schedule.jitter_rms_us, schedule.jitter_max_us and jitter.interval_ms.p99
+// from /stats for each.
+struct task_placement_t
+{
+    const char *name;
+    BaseType_t core;
+    UBaseType_t priority;
+    uint32_t stack_size;
+};
+
+static constexpr BaseType_t topology_core(int core) noexcept
+{
+#if CONFIG_FREERTOS_UNICORE
+    (void)core;
+    return 0;
+#elif CONFIG_APP_TASK_TOPOLOGY_UNPINNED
+    (void)core;
+    return tskNO_AFFINITY;
+#else
+    return core;
+#endif
+}
+
+static constexpr task_placement_t acquisition_task{
+    "PDAT_acquire",
+    topology_core(CONFIG_APP_ACQUISITION_TASK_CORE),
+    CONFIG_APP_ACQUISITION_TASK_PRIORITY,
+    CONFIG_APP_ACQUISITION_TASK_STACK};
+
+static constexpr task_placement_t processing_task{
+    "PDAT_process",
+    topology_core(CONFIG_APP_PROCESSING_TASK_CORE),
+    CONFIG_APP_PROCESSING_TASK_PRIORITY,
+    CONFIG_APP_PROCESSING_TASK_STACK};
+
+static constexpr task_placement_t web_server_task{
+    "httpd",
+    topology_core(CONFIG_APP_HTTPD_TASK_CORE),
+    CONFIG_APP_HTTPD_TASK_PRIORITY,
+    CONFIG_APP_HTTPD_TASK_STACK};
+
+static constexpr task_placement_t modbus_watch_task{
+    "MB_reads",
+    topology_core(CONFIG_APP_MODBUS_WATCH_TASK_CORE),
+    CONFIG_APP_MODBUS_WATCH_TASK_PRIORITY,
+    CONFIG_APP_MODBUS_WATCH_TASK_STACK};
+
+// Placed by esp-modbus, whatever the application tasks do; listed so checks
+// below see the whole topology
+#if CONFIG_FREERTOS_UNICORE
+static constexpr BaseType_t modbus_port_core = 0;
+#else
+static constexpr BaseType_t modbus_port_core = CONFIG_FMB_PORT_TASK_AFFINITY;
+#endif
+
+static constexpr task_placement_t modbus_port_task{
+    "port_serial",
+    modbus_port_core,
+    CONFIG_FMB_PORT_TASK_PRIO,
+    CONFIG_FMB_PORT_TASK_STACK_SIZE};
+
+#if !CONFIG_FREERTOS_UNICORE && !CONFIG_APP_TASK_TOPOLOGY_UNPINNED
+static_assert(modbus_port_task.core != acquisition_task.core &&
+                  (modbus_port_task.core != tskNO_AFFINITY || modbus_port_task.priority < acquisition_task.priority),
+              "RS485 traffic would preempt sensor requests; keep the Modbus port task off the acquisition core");
+#endif
+
+static_assert(acquisition_task.core != processing_task.core ||
+                  acquisition_task.priority > processing_task.priority,
+              "acquisition must preempt processing on a shared core");
+
+// Create a task as placed in the topology
+inline BaseType_t create_task(const task_placement_t &placement, TaskFunction_t fn,
+                              void *arg, TaskHandle_t *handle = nullptr) noexcept
+{
+    return xTaskCreatePinnedToCore(fn, placement.name, placement.stack_size, arg,
+                                   placement.priority, handle, placement.core);
+}
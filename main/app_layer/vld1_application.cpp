@@ -4,54 +4,299 @@ static constexpr char TAG[] = "Application";
 
 void application::start_read_and_forward()
 {
-    xTaskCreate(get_pdat_and_forward, "PDAT_read_forward", 4096, this, 5, nullptr);
-    ESP_LOGI(TAG, "PDAT read and forward task started.");
+    if (create_task(processing_task, process_pdat, this, &process_task_) != pdPASS ||
+        create_task(acquisition_task, acquire_pdat, this) != pdPASS ||
+        create_task(modbus_watch_task, watch_master_reads, this) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to create PDAT tasks.");
+        return;
+    }
+
+    ESP_LOGI(TAG, "PDAT acquisition (core %d, prio %u) and processing (core %d, prio %u) tasks started.",
+             static_cast<int>(acquisition_task.core), static_cast<unsigned>(acquisition_task.priority),
+             static_cast<int>(processing_task.core), static_cast<unsigned>(processing_task.priority));
 }
 
-void application::get_pdat_and_forward(void *arg)
+void application::acquire_pdat(void *arg)
 {
     auto *app = static_cast<application *>(arg);
 
     vld1 &sensor = *app->ctx_.vld1_sensor;
-    rs485 &rs485_slave = *app->ctx_.rs485_slave;
-    batch_averager &avg = *app->ctx_.averager;
+    telemetry &stats = *app->ctx_.stats;
     led &led_main = *app->ctx_.main_led;
 
-    vld1::pdat_payload_t pdat_data{};
-    uint16_t rs485_regs[4] = {0xFFFF, 0xFFFF, 0xFFFF, 0x0000};
+    acquired_frame_t frame{};
+    rate_scheduler scheduler(acquisition_rate_hz);
+    if (scheduler.start() != ESP_OK)
+        ESP_LOGW(TAG, "Acquisition pacing unavailable; polling as fast as the sensor answers.");
+    error_backoff backoff(error_backoff_min_ms, error_backoff_max_ms);
+    bool reported_ok = false;
 
     while (true)
     {
-        vld1::vld1_error_code_t err = sensor.get_pdat(pdat_data);
+        scheduler.wait();
 
-        if (err == vld1::vld1_error_code_t::OK)
+        // While the sensor fails, requests are spaced out by the backoff: a
+        // paced loop skips its cycles, a free-running one sleeps.
+        const int64_t now_us = esp_timer_get_time();
+        if (!backoff.attempt_due(now_us))
         {
-            float distance_m = pdat_data.distance;
-            uint16_t distance_mm = static_cast<uint16_t>(distance_m * 1000.0f);
+            if (scheduler.rate_hz() == 0)
+                vTaskDelay(pdMS_TO_TICKS(backoff.until_attempt_us(now_us) / 1000) + 1);
+            continue;
+        }
+
+        frame.err = sensor.get_pdat(frame.pdat, &frame.timing);
+        frame.timestamp_us = esp_timer_get_time();
 
-            avg.add_sample(distance_m);
-            uint16_t avg_distance_mm = avg.average_millimeters();
+        if (frame.err == vld1::vld1_error_code_t::OK)
+        {
+            led_main.post_activity();
+            if (backoff.on_success(frame.timestamp_us))
+            {
+                ESP_LOGI(TAG, "Sensor recovered after %" PRIi64 " ms outage, detected within %" PRIi64 " ms.",
+                         backoff.last_outage_us() / 1000, backoff.last_recovery_us() / 1000);
+            }
+            if (!reported_ok)
+            {
+                publish_health(backoff, true, stats);
+                reported_ok = true;
+            }
+        }
+        else
+        {
+            led_main.post_error(static_cast<uint8_t>(frame.err));
 
-            rs485_regs[0] = distance_mm;
-            rs485_regs[1] = pdat_data.magnitude;
-            rs485_regs[2] = avg_distance_mm;
-            rs485_regs[3] = static_cast<uint16_t>(err);
+            const bool was_failing = backoff.failing();
+            const bool was_at_max = backoff.at_max_delay();
+            backoff.on_failure(frame.timestamp_us);
+            if (!was_failing)
+            {
+                ESP_LOGW(TAG, "Sensor request failed (error %u), backing off.",
+                         static_cast<unsigned>(frame.err));
+            }
+            else if (!was_at_max && backoff.at_max_delay())
+            {
+                ESP_LOGW(TAG, "Sensor still failing after %" PRIu32 " requests, probing every %" PRIu32 " ms.",
+                         backoff.consecutive_failures(), error_backoff_max_ms);
+            }
+            publish_health(backoff, false, stats);
+            reported_ok = false;
+        }
 
-            ESP_LOGI(TAG, "Distance=%u mm | Mag=%u dB | Avg=%u mm",
-                     distance_mm, (pdat_data.magnitude / 100), avg_distance_mm);
+        // Back-pressure: PDAT is polled, so waiting for queue space delays the
+        // next request instead of losing a frame. Drop only if it stays full.
+        bool queued = app->frames_.push(frame);
+        for (int waited = 0; !queued && waited < frame_backpressure_ticks; ++waited)
+        {
+            stats.note_backpressure_wait();
+            vTaskDelay(1);
+            queued = app->frames_.push(frame);
+        }
 
-            rs485_slave.write(rs485_regs, 4);
+        if (queued)
+        {
+            stats.note_frame_queued(app->frames_.size());
+            xTaskNotifyGive(app->process_task_);
         }
         else
         {
-            rs485_regs[0] = 0xFFFF;
-            rs485_regs[1] = 0xFFFF;
-            rs485_regs[2] = 0xFFFF;
-            rs485_regs[3] = static_cast<uint16_t>(err);
-            rs485_slave.write(rs485_regs, 4);
+            stats.note_frame_dropped();
+        }
+
+        const rate_scheduler::stats_t sched = scheduler.stats();
+        stats.publish_schedule({scheduler.rate_hz(), sched.cycles, sched.overruns,
+                                sched.achieved_hz, sched.jitter_rms_us, sched.jitter_max_us});
+
+        const uart::rx_stats_t &rx = sensor.transport().rx_stats();
+        stats.publish_serial({rx.frames, static_cast<uint32_t>(rx.last_us),
+                              rx.frames ? static_cast<uint32_t>(rx.total_us / rx.frames) : 0,
+                              static_cast<uint32_t>(rx.max_us)});
+    }
+}
+
+void application::process_pdat(void *arg)
+{
+    auto *app = static_cast<application *>(arg);
+
+    rs485 &rs485_slave = *app->ctx_.rs485_slave;
+    distance_averager &avg = *app->ctx_.averager;
+    distance_tracker &tracker = *app->ctx_.tracker;
+    telemetry &stats = *app->ctx_.stats;
+
+    time_ema<float> output_smoother(output_time_constant_ms);
+    bool averager_primed = false;
+
+    acquired_frame_t frame{};
+    telemetry::reacquisition_stats_t reacquisition{};
+    int64_t last_on_track_us = 0;
+    uint16_t rs485_regs[app_register_count] = {0xFFFF, 0xFFFF, 0xFFFF, 0x0000, 0xFFFF, velocity_no_data};
+
+    avg.set_window(averager_window);
+    avg.set_max_age_ms(averager_window_ms);
+    avg.set_output_decimation(averager_decimation);
+    ESP_LOGI(TAG, "Averaging window: %" PRIu32 " ms, up to %u frames, re-acquisition after %u frames",
+             avg.max_age_ms(), static_cast<unsigned>(avg.window()), static_cast<unsigned>(avg.reacquire_count()));
+    publish_averager_settings(avg, stats);
+
+    while (true)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        apply_averager_settings(avg, stats);
+
+        while (app->frames_.pop(frame))
+        {
+            const vld1::pdat_payload_t &pdat_data = frame.pdat;
+            const vld1::vld1_error_code_t err = frame.err;
+            const int64_t timestamp_us = frame.timestamp_us;
+            telemetry::frame_trace_t trace{0, frame.timing.gnfd_sent_us, frame.timing.resp_received_us,
+                                           frame.timing.pdat_decoded_us, 0, 0, 0};
+
+            if (err == vld1::vld1_error_code_t::OK)
+            {
+                float distance_m = pdat_data.distance;
+                uint16_t distance_mm = static_cast<uint16_t>(distance_m * 1000.0f);
+
+                const bool averaged = avg.add_sample(distance_m, pdat_data.magnitude, timestamp_us);
+                stats.note_weak_samples(avg.weak_samples());
+                uint16_t avg_distance_mm = avg.average_millimeters();
+
+                averager_primed = averager_primed || avg.is_complete();
+                if (output_time_constant_ms > 0 && averager_primed)
+                {
+                    float smoothed_m = static_cast<float>(avg.average_meters());
+                    output_smoother.process(smoothed_m, timestamp_us);
+                    avg_distance_mm = sample_traits<float>::to_millimeters(smoothed_m);
+                }
+                trace.averaged_us = esp_timer_get_time();
+
+                // Settling runs from the last frame the averager accepted to the
+                // frame that re-seeded it on the new position
+                if (avg.reacquisitions() != reacquisition.reacquisitions)
+                {
+                    const uint32_t settling_ms = static_cast<uint32_t>((timestamp_us - last_on_track_us) / 1000);
+                    reacquisition = {avg.reacquisitions(), avg.last_settling_samples(), settling_ms,
+                                     std::max(settling_ms, reacquisition.max_settling_ms)};
+                    stats.publish_reacquisition(reacquisition);
+                    ESP_LOGW(TAG, "Target moved, averager re-seeded after %" PRIu32 " samples (%" PRIu32 " ms).",
+                             reacquisition.last_settling_samples, settling_ms);
+                }
+                if (averaged && avg.pending_rejections() == 0)
+                    last_on_track_us = timestamp_us;
+
+                const float deviation_m = avg.is_complete()
+                                              ? std::fabs(distance_m - static_cast<float>(avg.average_meters()))
+                                              : -1.0f;
+                stats.record_frame(deviation_m, timestamp_us);
+
+                tracker.update(distance_m, timestamp_us);
+
+                rs485_regs[0] = distance_mm;
+                rs485_regs[1] = pdat_data.magnitude;
+                rs485_regs[2] = avg_distance_mm;
+                rs485_regs[3] = static_cast<uint16_t>(err);
+
+                // Until the tracker has a lock (start-up, or re-initialising
+                // after a run of gated misses) its state is zero, not a target
+                if (tracker.is_tracking())
+                {
+                    const float tracked_mm = tracker.distance() * 1000.0f;
+                    const float velocity_mm_s = tracker.velocity() * 1000.0f;
+                    rs485_regs[4] = static_cast<uint16_t>(std::clamp(tracked_mm, 0.0f, 65535.0f));
+                    rs485_regs[5] = static_cast<uint16_t>(static_cast<int16_t>(std::clamp(velocity_mm_s, -32767.0f, 32767.0f)));
+                }
+                else
+                {
+                    rs485_regs[4] = 0xFFFF;
+                    rs485_regs[5] = velocity_no_data;
+                }
+
+                rs485_slave.write(rs485_regs, app_register_count);
+                trace.registers_us = esp_timer_get_time();
+                stats.record_trace(trace);
+
+                ESP_LOGI(TAG, "Distance=%u mm | Mag=%u dB | Avg=%u mm | Track=%u mm | Vel=%d mm/s",
+                         distance_mm, (pdat_data.magnitude / 100), avg_distance_mm,
+                         rs485_regs[4], static_cast<int16_t>(rs485_regs[5]));
+                stats.publish({timestamp_us, distance_m, static_cast<float>(avg.average_meters()),
+                               pdat_data.magnitude, static_cast<uint16_t>(err)});
+            }
+            else
+            {
+                rs485_regs[0] = 0xFFFF;
+                rs485_regs[1] = 0xFFFF;
+                rs485_regs[2] = 0xFFFF;
+                rs485_regs[3] = static_cast<uint16_t>(err);
+                rs485_regs[4] = 0xFFFF;
+                rs485_regs[5] = velocity_no_data;
+                rs485_slave.write(rs485_regs, app_register_count);
+                trace.registers_us = esp_timer_get_time();
+                stats.record_trace(trace);
+                stats.publish({timestamp_us, NAN, NAN, 0, static_cast<uint16_t>(err)});
+            }
         }
+    }
+}
+
+void application::watch_master_reads(void *arg)
+{
+    auto *app = static_cast<application *>(arg);
+
+    rs485 &rs485_slave = *app->ctx_.rs485_slave;
+    telemetry &stats = *app->ctx_.stats;
+
+    // Draining the parameter queue also keeps the Modbus port task from
+    // waiting on it when it fills up.
+    int64_t read_us = 0;
+    while (true)
+    {
+        const esp_err_t err = rs485_slave.wait_read(read_us, 1000);
+        if (err == ESP_OK)
+            stats.note_master_read(read_us);
+        else if (err == ESP_ERR_INVALID_STATE)
+            vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+}
+
+void application::publish_health(const error_backoff &backoff, bool sensor_ok, telemetry &stats) noexcept
+{
+    stats.publish_health({sensor_ok,
+                          backoff.consecutive_failures(),
+                          backoff.failures(),
+                          backoff.outages(),
+                          static_cast<uint32_t>(backoff.delay_us() / 1000),
+                          static_cast<uint32_t>(backoff.last_outage_us() / 1000),
+                          static_cast<uint32_t>(backoff.last_recovery_us() / 1000),
+                          static_cast<uint32_t>(backoff.max_recovery_us() / 1000)});
+}
+
+void application::publish_averager_settings(const distance_averager &avg, telemetry &stats) noexcept
+{
+    stats.publish_averager_settings({static_cast<uint16_t>(avg.window()),
+                                     static_cast<uint16_t>(avg.capacity()),
+                                     static_cast<float>(avg.max_step()),
+                                     static_cast<float>(avg.hampel_threshold()),
+                                     static_cast<float>(avg.trim_fraction()),
+                                     static_cast<uint16_t>(avg.reacquire_count()),
+                                     static_cast<uint16_t>(avg.max_reacquire_count)});
+}
 
-        led_main.blink(2, 20);
-        vTaskDelay(pdMS_TO_TICKS(1));
+void application::apply_averager_settings(distance_averager &avg, telemetry &stats) noexcept
+{
+    telemetry::averager_settings_t settings{};
+    if (!stats.take_averager_settings(settings))
+        return;
+
+    if (!avg.set_window(settings.window))
+    {
+        ESP_LOGW(TAG, "Averager window %u out of range (1..%u); keeping %u.",
+                 settings.window, static_cast<unsigned>(avg.capacity()), static_cast<unsigned>(avg.window()));
     }
+    avg.set_limits(settings.max_step_m, settings.hampel_thresh, settings.trim_fraction);
+    avg.set_reacquire_count(settings.reacquire_count);
+
+    ESP_LOGI(TAG, "Averager retuned: window=%u max_step=%.3f m hampel=%.2f trim=%.2f reacquire=%u",
+             static_cast<unsigned>(avg.window()), avg.max_step(), avg.hampel_threshold(), avg.trim_fraction(),
+             static_cast<unsigned>(avg.reacquire_count()));
+    publish_averager_settings(avg, stats);
 }
@@ -4,18 +4,103 @@
 #include "rs485_slave.hpp"
 #include "vld1.hpp"
 #include "averager.hpp"
+#include "fixed_batch_averager.hpp"
+#include "filter_stages.hpp"
+#include "alpha_beta_tracker.hpp"
 #include "led.hpp"
+#include "telemetry.hpp"
+#include "spsc_ring.hpp"
+#include "rate_scheduler.hpp"
+#include "error_backoff.hpp"
+#include "task_topology.hpp"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include <cstring>
 #include <cinttypes>
+#include <algorithm>
+#include <cmath>
+
+#if CONFIG_APP_AVERAGER_SAMPLE_DOUBLE
+using averager_sample_t = double;
+#elif CONFIG_APP_AVERAGER_SAMPLE_Q16_16
+using averager_sample_t = q16_16;
+#else
+using averager_sample_t = float;
+#endif
+
+#if CONFIG_APP_AVERAGER_WEIGHTED
+static constexpr bool averager_weighted = true;
+#else
+static constexpr bool averager_weighted = false;
+#endif
+
+static constexpr uint16_t averager_magnitude_floor = CONFIG_APP_AVERAGER_MAGNITUDE_FLOOR;
+static constexpr size_t averager_decimation = CONFIG_APP_AVERAGER_DECIMATION;
+static constexpr int output_time_constant_ms = CONFIG_APP_OUTPUT_TIME_CONSTANT_MS;
+
+// Room for the window to be widened at runtime from the web page; the active
+// window starts at averager_window below. Samples are timestamped so the
+// window also drops frames older than its configured span.
+static constexpr size_t averager_capacity = 64;
+using distance_averager = fixed_batch_averager<averager_capacity, averager_sample_t, averager_weighted, true>;
+static constexpr uint32_t averager_window_ms = CONFIG_APP_AVERAGER_WINDOW_MS;
+using distance_tracker = alpha_beta_tracker<float>;
+
+// Modbus input registers: 0 distance mm, 1 magnitude, 2 averaged distance mm,
+// 3 error code, 4 tracked distance mm, 5 radial velocity mm/s (int16).
+// While the tracker has no lock, or on a sensor error, 4 reads 0xFFFF and 5
+// reads velocity_no_data (INT16_MIN); velocities are clamped to +-32767 so
+// that value never stands for a reading.
+static constexpr size_t app_register_count = 6;
+static constexpr uint16_t velocity_no_data = 0x8000;
+
+// Frame handed from the acquisition task to the processing task
+struct acquired_frame_t
+{
+    int64_t timestamp_us;
+    vld1::pdat_timing_t timing;
+    vld1::pdat_payload_t pdat;
+    vld1::vld1_error_code_t err;
+};
+
+static constexpr uint32_t acquisition_rate_hz = CONFIG_APP_ACQUISITION_RATE_HZ;
+
+// Averaging window in frames, from its configured span at the paced rate.
+// The span itself is enforced by age, so when frames come slower than paced
+// the window holds fewer of them instead of reaching further back. Unpaced,
+// the frame count is left at the capacity and only the age bounds it.
+static constexpr size_t averager_window =
+    acquisition_rate_hz == 0
+        ? distance_averager::capacity()
+        : std::clamp<size_t>((size_t(averager_window_ms) * acquisition_rate_hz + 500) / 1000,
+                             1, distance_averager::capacity());
+
+// Consistent out-of-step frames that re-seed the averager after the target
+// moved, from the configured settling time at the paced rate
+static constexpr size_t default_averager_reacquire_count = 5;
+static constexpr size_t averager_reacquire_count =
+    acquisition_rate_hz == 0
+        ? default_averager_reacquire_count
+        : std::clamp<size_t>((size_t(CONFIG_APP_AVERAGER_SETTLING_MS) * acquisition_rate_hz + 500) / 1000,
+                             1, distance_averager::max_reacquire_count);
+
+static constexpr size_t frame_queue_length = 16;
+// Ticks acquisition waits for queue space before dropping a frame
+static constexpr int frame_backpressure_ticks = 5;
+static constexpr uint32_t error_backoff_min_ms = CONFIG_APP_ERROR_BACKOFF_MIN_MS;
+static constexpr uint32_t error_backoff_max_ms = CONFIG_APP_ERROR_BACKOFF_MAX_MS;
+static_assert(error_backoff_min_ms <= error_backoff_max_ms, "backoff must not start above its cap");
 
 struct app_context
 {
     rs485 *rs485_slave;
     vld1 *vld1_sensor;
-    batch_averager *averager;
+    distance_averager *averager;
+    distance_tracker *tracker;
+    telemetry *stats;
     led *main_led;
 };
 
@@ -24,15 +109,24 @@ class application
 public:
     application(rs485 &rs_slave,
                 vld1 &vld1_sensor,
-                batch_averager &avg,
+                distance_averager &avg,
+                distance_tracker &tracker,
+                telemetry &stats,
                 led &led_main) noexcept
-        : ctx_{&rs_slave, &vld1_sensor, &avg, &led_main}
+        : ctx_{&rs_slave, &vld1_sensor, &avg, &tracker, &stats, &led_main}
     {
     }
 
     void start_read_and_forward();
 
 private:
-    static void get_pdat_and_forward(void *arg);
+    static void acquire_pdat(void *arg);
+    static void process_pdat(void *arg);
+    static void watch_master_reads(void *arg);
+    static void publish_health(const error_backoff &backoff, bool sensor_ok, telemetry &stats) noexcept;
+    static void publish_averager_settings(const distance_averager &avg, telemetry &stats) noexcept;
+    static void apply_averager_settings(distance_averager &avg, telemetry &stats) noexcept;
     app_context ctx_;
+    spsc_ring<acquired_frame_t, frame_queue_length> frames_;
+    TaskHandle_t process_task_ = nullptr;
 };
@@ -27,27 +27,31 @@ extern "C" void app_main()
     ESP_ERROR_CHECK(ret);
 
     static uart vld1_uart(UART_NUM_1, 12, 13, 115200, 512);
-    vld1_uart.init(UART_DATA_8_BITS, UART_PARITY_EVEN, UART_STOP_BITS_1);
+    vld1_uart.init(UART_DATA_8_BITS, UART_PARITY_EVEN, UART_STOP_BITS_1,
+                   uart::rx_tuning_low_latency(sizeof(vld1::resp_t)));
 
     static uart rs485_uart(UART_NUM_2, 17, 16, 9600, 512);
     static rs485 rs485_slave(rs485_uart, GPIO_NUM_5);
-    rs485_slave.init(1, MB_PARAM_INPUT, 4);
+    rs485_slave.init(1, MB_PARAM_INPUT, app_register_count);
 
     static led main_led(GPIO_NUM_2);
     main_led.init();
     main_led.blink(1, 100);
+    main_led.set_heartbeat(true);
 
     static vld1 vld1_sensor(vld1_uart);
-    static batch_averager averager(20);
+    static distance_averager averager(0.05, 3.0, 0.1, averager_reacquire_count, averager_magnitude_floor);
+    static distance_tracker tracker;
+    static telemetry stats;
 
-    static application app(rs485_slave, vld1_sensor, averager, main_led);
+    static application app(rs485_slave, vld1_sensor, averager, tracker, stats, main_led);
 
     vld1_sensor.init();
     vld1_sensor.restore_config();
     vld1_sensor.get_parameters();
 
-    static web_server server(vld1_sensor);
-    server.init();
+    static web_server server(vld1_sensor, stats);
+    server.init(web_server_task.core, web_server_task.priority, web_server_task.stack_size);
 
     ESP_LOGI(TAG, "System initialized successfully");
     ESP_LOGI(TAG, "Connect to SSID: %s", server.get_ssid().c_str());